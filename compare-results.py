@@ -0,0 +1,169 @@
+from __future__ import print_function
+
+import sys
+import numpy as np
+import pandas as pd
+from argparse import ArgumentParser
+import wcrt_results
+
+
+def read_results(results, key=None):
+    """
+    Read a results file written by wcrt-test-sim --results, or a HDF5 store with
+    the results of wcrt-test-mbed.py or wcrt-test-sim --store, as a DataFrame with
+    the method, uf, ntask and rts_id of each row, and its cost metrics.
+    """
+    if wcrt_results.is_results_file(results):
+        names = wcrt_results.method_names(results)
+        df = pd.concat([pd.DataFrame(chunk) for chunk in wcrt_results.read_chunks(results, "rts")], ignore_index=True)
+        df["method"] = df["method_id"].apply(lambda x: names[x])
+        df = df.drop(columns=["run", "method_id"])
+    else:
+        with pd.HDFStore(results, mode="r") as store:
+            if key is None:
+                if len(store.keys()) != 1:
+                    print("{0}: select a key from {1}.".format(results, store.keys()), file=sys.stderr)
+                    sys.exit(1)
+                key = store.keys()[0]
+            df = store[key]
+        df = df.rename(columns={"fu": "uf", "rts_size": "ntask"})
+        if "method" not in df.columns:
+            df["method"] = df["method_id"].apply(lambda x: wcrt_results.STORE_METHOD_NAMES[x])
+        df = df.drop(columns=["method_id"])
+
+    df["method"] = df["method"].str.upper()
+
+    # the same rts may be evaluated more than once (for example, several runs
+    # appended to a results file), so the n-th result of a rts in one set is
+    # paired with the n-th result of the same rts in the other
+    df["seq"] = df.groupby(["method", "uf", "ntask", "rts_id"]).cumcount()
+
+    return df
+
+
+def bootstrap_ratio(a, b, paired, samples, alpha, rnd):
+    """
+    Ratio of the means of b and a, and its bootstrap confidence interval. Paired
+    values (the same rts in both sets) are resampled together.
+    """
+    ratio = b.mean() / a.mean() if a.mean() > 0 else np.nan
+
+    if paired:
+        idx = rnd.randint(0, len(a), size=(samples, len(a)))
+        mean_a, mean_b = a[idx].mean(axis=1), b[idx].mean(axis=1)
+    else:
+        mean_a = a[rnd.randint(0, len(a), size=(samples, len(a)))].mean(axis=1)
+        mean_b = b[rnd.randint(0, len(b), size=(samples, len(b)))].mean(axis=1)
+
+    with np.errstate(divide="ignore", invalid="ignore"):
+        ratios = mean_b / mean_a
+    ratios = ratios[np.isfinite(ratios)]
+    if len(ratios) == 0:
+        return ratio, np.nan, np.nan
+
+    lo, hi = np.percentile(ratios, [100 * alpha / 2, 100 * (1 - alpha / 2)])
+    return ratio, lo, hi
+
+
+def compare(df_a, df_b, metrics, samples, alpha, threshold, seed):
+    """
+    Compare the metrics of each method, for each uf and for all the rts. A method
+    is slower when the lower limit of the confidence interval of the ratio B / A
+    is above 1 + threshold, and faster when the upper limit is below 1 - threshold.
+    """
+    rnd = np.random.RandomState(seed)
+    keys = ["method", "uf", "ntask", "rts_id", "seq"]
+    paired = df_a[keys + metrics].merge(df_b[keys + metrics], on=keys, suffixes=("_a", "_b"))
+
+    rows = []
+    for method in sorted(set(df_a["method"]) & set(df_b["method"])):
+        pm = paired[paired["method"] == method]
+        am = df_a[df_a["method"] == method]
+        bm = df_b[df_b["method"] == method]
+        for uf in sorted(set(am["uf"]) & set(bm["uf"])) + ["all"]:
+            pu = pm if uf == "all" else pm[pm["uf"] == uf]
+            au = am if uf == "all" else am[am["uf"] == uf]
+            bu = bm if uf == "all" else bm[bm["uf"] == uf]
+            # the rts are paired only if both sets have the same rts
+            is_paired = len(pu) == len(au) == len(bu)
+            for metric in metrics:
+                if is_paired:
+                    a = pu[metric + "_a"].values.astype(np.float64)
+                    b = pu[metric + "_b"].values.astype(np.float64)
+                else:
+                    a = au[metric].values.astype(np.float64)
+                    b = bu[metric].values.astype(np.float64)
+                ratio, lo, hi = bootstrap_ratio(a, b, is_paired, samples, alpha, rnd)
+                status = "slower" if lo > 1 + threshold else "faster" if hi < 1 - threshold else ""
+                rows.append([method, uf, metric, len(a), len(b), is_paired, a.mean(), b.mean(), ratio, lo, hi, status])
+
+    return pd.DataFrame(rows, columns=["method", "uf", "metric", "count_a", "count_b", "paired",
+                                       "mean_a", "mean_b", "ratio", "ci_lo", "ci_hi", "status"])
+
+
+def get_args():
+    """ Command line arguments """
+    parser = ArgumentParser(description="Compare the cost of the methods in two result sets of the same rts (for " +
+                                        "example, two builds of the board firmware main_wcrt.cpp with different " +
+                                        "REMOVE_SUBTRACTION_RTA4, DONT_USE_MIN_B_RTA4 or CHECK_DEADLINE_AFTER_FOR " +
+                                        "values, or two versions of wcrt-test-sim), with the bootstrap confidence interval of the ratio of the means " +
+                                        "of each method and uf. Exit with status 1 if a method is slower.")
+    parser.add_argument("a", help="Baseline results file or HDF5 store.", type=str)
+    parser.add_argument("b", help="Results file or HDF5 store to compare with the baseline.", type=str)
+    parser.add_argument("--key-a", help="Key of the baseline results in the store.", type=str)
+    parser.add_argument("--key-b", help="Key of the results in the store.", type=str)
+    parser.add_argument("--cols", help="Metrics to compare (default: the cost metrics in both sets).", nargs="+")
+    parser.add_argument("--methods", help="Methods to compare (default: all in both sets).", nargs="+")
+    parser.add_argument("--threshold", help="Relative change ignored (default 0.02).", type=float, default=0.02)
+    parser.add_argument("--alpha", help="1 - confidence level of the intervals (default 0.05).", type=float, default=0.05)
+    parser.add_argument("--samples", help="Bootstrap samples (default 2000).", type=int, default=2000)
+    parser.add_argument("--seed", help="Seed of the bootstrap samples (default 1).", type=int, default=1)
+    parser.add_argument("--fail-cols", help="Metrics whose slowdown fails the comparison (default: all compared).",
+                        nargs="+")
+    parser.add_argument("--save-as", help="Save the comparison as a CSV file.", type=str, metavar="file")
+    return parser.parse_args()
+
+
+def main():
+    args = get_args()
+
+    try:
+        df_a = read_results(args.a, args.key_a)
+        df_b = read_results(args.b, args.key_b)
+    except (IOError, KeyError) as e:
+        print(e, file=sys.stderr)
+        sys.exit(2)
+
+    cost_cols = ["usecs", "cycles", "nsecs", "cc", "loops"]
+    metrics = args.cols if args.cols else [c for c in cost_cols if c in df_a.columns and c in df_b.columns]
+    missing = [c for c in metrics if c not in df_a.columns or c not in df_b.columns]
+    if missing or not metrics:
+        print("Error: metrics {0} not in both result sets.".format(missing), file=sys.stderr)
+        sys.exit(2)
+
+    if args.methods:
+        methods = [m.upper() for m in args.methods]
+        df_a = df_a[df_a["method"].isin(methods)]
+        df_b = df_b[df_b["method"].isin(methods)]
+
+    result = compare(df_a, df_b, metrics, args.samples, args.alpha, args.threshold, args.seed)
+    if result.empty:
+        print("Error: no methods in both result sets.", file=sys.stderr)
+        sys.exit(2)
+
+    pd.set_option("display.width", 200)
+    print(result.to_string(index=False, float_format=lambda x: "{0:.4f}".format(x)))
+
+    if args.save_as:
+        result.to_csv(args.save_as, index=False)
+
+    fail_cols = args.fail_cols if args.fail_cols else metrics
+    slower = result[(result["status"] == "slower") & result["metric"].isin(fail_cols)]
+    if not slower.empty:
+        print("\n{0} method(s) slower: {1}.".format(slower["method"].nunique(), ", ".join(sorted(slower["method"].unique()))),
+              file=sys.stderr)
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
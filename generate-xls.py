@@ -6,6 +6,8 @@ import sys
 import pandas as pd
 import numpy as np
 from argparse import ArgumentParser
+import wcrt_results
+from wcrt_sketch import Sketch
 
 
 def draw_graph(xls_writer, sheet, data, row_start):
@@ -110,8 +112,7 @@ def generate_xls(df, xls_file, methods=[], metrics=[], metadata=None, overwrite=
         # capitalized method names
         df['method'] = df['method'].str.upper()
     else:
-        method_names = {0: 'het', 1: 'het2', 2: 'rta', 3: 'rta2', 4: 'rta3', 5: 'rta4'}
-        df['method'] = df['method_id'].apply(lambda x: method_names[x].upper())
+        df['method'] = df['method_id'].apply(lambda x: wcrt_results.STORE_METHOD_NAMES[x].upper())
 
     # select only the rows with the specified methods
     if methods:
@@ -123,6 +124,10 @@ def generate_xls(df, xls_file, methods=[], metrics=[], metadata=None, overwrite=
     # compute mean and other metrics.
     df_method_rts_agg = df.groupby(["method", "uf"], as_index=False)[cols].agg([np.mean, np.max, np.min, np.median, np.std])
 
+    write_xls(df_method_rts_agg, xls_file, metadata)
+
+
+def write_xls(df_method_rts_agg, xls_file, metadata=None):
     # create a Pandas Excel writer using XlsxWriter as the engine.
     writer = pd.ExcelWriter(xls_file, engine='xlsxwriter')
 
@@ -138,6 +143,125 @@ def generate_xls(df, xls_file, methods=[], metrics=[], metadata=None, overwrite=
     writer.close()
 
 
+def aggregate_results(results_file, methods=[], metrics=[]):
+    """
+    Same metrics as generate_xls, for a results file written by wcrt-test-sim --results.
+    The file is read one chunk at a time, keeping only the values needed by each
+    (method, uf) group: count, mean and sum of squared deviations (merged chunk by
+    chunk as in Welford's algorithm), min, max and a quantile sketch of the values
+    (for the median, within the 1% relative error of the sketch).
+    """
+    method_names = [m.upper() for m in wcrt_results.method_names(results_file)]
+    methods = [m.upper() for m in methods]
+
+    cols = [col for col in metrics if col in ["cc", "loops", "nsecs"]]
+    if not cols:
+        print("Warning: the specified columns do not exists in the results file.", file=sys.stderr)
+        cols = ["cc", "loops", "nsecs"]
+
+    groups = {}
+    for chunk in wcrt_results.read_chunks(results_file, "rts", ["method_id", "uf"] + cols):
+        keys = chunk["method_id"] * 1000 + chunk["uf"]
+        for key in np.unique(keys):
+            method = method_names[key // 1000]
+            if methods and method not in methods:
+                continue
+            sel = keys == key
+            g = groups.setdefault((method, key % 1000), {col: [0, 0.0, 0.0, None, None, Sketch()] for col in cols})
+            for col in cols:
+                values = chunk[col][sel].astype(np.float64)
+                acc = g[col]
+                n = acc[0] + len(values)
+                mean = values.mean()
+                delta = mean - acc[1]
+                acc[2] += np.square(values - mean).sum() + delta * delta * acc[0] * len(values) / n
+                acc[1] += delta * len(values) / n
+                acc[0] = n
+                acc[3] = values.min() if acc[3] is None else min(acc[3], values.min())
+                acc[4] = values.max() if acc[4] is None else max(acc[4], values.max())
+                acc[5].add(chunk[col][sel])
+
+    if not groups:
+        print("Error: no valid methods found.", file=sys.stderr)
+        exit(1)
+
+    rows = []
+    index = sorted(groups)
+    for key in index:
+        row = []
+        for col in cols:
+            n, mean, m2, vmin, vmax, sketch = groups[key][col]
+            std = np.sqrt(m2 / (n - 1)) if n > 1 else np.nan
+            row.extend([mean, vmax, vmin, sketch.quantile(0.5), std])
+        rows.append(row)
+
+    columns = pd.MultiIndex.from_product([cols, ["mean", "amax", "amin", "median", "std"]])
+    return pd.DataFrame(rows, index=pd.MultiIndex.from_tuples(index, names=["method", "uf"]), columns=columns)
+
+
+def results_file(args):
+    """ Generate the xls file from a results file written by wcrt-test-sim --results """
+    if args.list_keys or args.list_cols:
+        print("run, rts_id, uf, ntask, method_id, sched, cc, loops, nsecs")
+        exit(0)
+
+    xls = get_valid_filename(args.save_as if args.save_as else "{0}.xlsx".format(os.path.basename(args.file)))
+    if os.path.isfile(xls) and not args.overwrite:
+        print("Error: file {0} already exists.".format(xls), file=sys.stderr)
+        exit(1)
+
+    write_xls(aggregate_results(args.file, args.methods, args.cols), xls)
+
+
+def is_buckets_file(f):
+    """ Check if the file is a buckets file written by wcrt-test-sim --buckets """
+    with open(f, "rb") as fp:
+        return fp.readline().startswith(b"method,uf,ntask,count,")
+
+
+def buckets_file(args):
+    """
+    Generate the xls file from a buckets file written by wcrt-test-sim --buckets.
+    The file already has the metrics of each (method, uf, ntask) bucket, so only
+    the rows with the selected number of tasks are used.
+    """
+    if args.list_keys or args.list_cols:
+        print(", ".join(pd.read_csv(args.file, nrows=0).columns))
+        exit(0)
+
+    df = pd.read_csv(args.file)
+    df["method"] = df["method"].str.upper()
+
+    if args.methods:
+        df = df[df["method"].isin([m.upper() for m in args.methods])]
+    if args.ntask:
+        df = df[df["ntask"] == args.ntask]
+    if df.empty:
+        print("Error: no valid methods found.", file=sys.stderr)
+        exit(1)
+    if df["ntask"].nunique() > 1:
+        print("Error: the file has rts with {0} tasks, select one with --ntask.".format(sorted(df["ntask"].unique())),
+              file=sys.stderr)
+        exit(1)
+
+    cols = [col for col in args.cols if col in ["cc", "loops", "nsecs"]]
+    if not cols:
+        print("Warning: the specified columns do not exists in the buckets file.", file=sys.stderr)
+        cols = ["cc", "loops", "nsecs"]
+
+    stats = [("mean", "mean"), ("amax", "max"), ("amin", "min"), ("median", "median"), ("std", "sd")]
+    df = df.set_index(["method", "uf"]).sort_index()
+    df_method_rts_agg = pd.DataFrame({(col, agg): df["{0}_{1}".format(col, name)] for col in cols for agg, name in stats})
+    df_method_rts_agg.columns = pd.MultiIndex.from_product([cols, [agg for agg, _ in stats]])
+
+    xls = get_valid_filename(args.save_as if args.save_as else "{0}.xlsx".format(os.path.basename(args.file)))
+    if os.path.isfile(xls) and not args.overwrite:
+        print("Error: file {0} already exists.".format(xls), file=sys.stderr)
+        exit(1)
+
+    write_xls(df_method_rts_agg, xls)
+
+
 def get_valid_filename(s):
     """
     Return the given string converted to a string that can be used for a clean
@@ -166,6 +290,7 @@ def get_args():
     parser.add_argument("--methods", help="Methods to include in the report.", nargs="+")
     parser.add_argument("--overwrite", help="Overwrite XLS file if exists.", default=False, action="store_true")
     parser.add_argument("--save-as", help="Name for the output xls file.", type=str, metavar="file")
+    parser.add_argument("--ntask", help="Number of tasks of the rts used from a buckets file.", type=int)
     return parser.parse_args()
 
 
@@ -210,7 +335,12 @@ def main():
     args = get_args()
 
     try:
-        hdfs_file(args)        
+        if wcrt_results.is_results_file(args.file):
+            results_file(args)
+        elif is_buckets_file(args.file):
+            buckets_file(args)
+        else:
+            hdfs_file(args)        
     except IOError as e:
         print(e)
 
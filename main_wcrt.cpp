@@ -46,6 +46,7 @@
 #define TEST_RTA4    1 // <-- THIS IS THE PUBLISHED METHOD
 #define TEST_HET     0
 #define TEST_HET2    1
+#define TEST_HETI    1
 */
 
 /*
@@ -77,6 +78,19 @@
  * the tasks.
  */
 #define SUM_CC_LOOPS 1
+/*
+ * 18/10/2026
+ * If equal to 1, the stack below test_method is painted before running each method,
+ * and the number of bytes used by the method is sent after the cpu cycles. The
+ * methods do not use the heap.
+ */
+#ifndef MEASURE_STACK
+#define MEASURE_STACK 0
+#endif
+#ifndef STACK_PAINT_SIZE
+#define STACK_PAINT_SIZE 4096
+#endif
+#define STACK_PATTERN 0xA5A5A5A5
 
 /*
  * Count cpu cycles.
@@ -173,12 +187,14 @@ uint32_t sum_for_count;
 
 void het_wcrt();
 void het2_wcrt();
+void heti_wcrt();
 void rta4_wcrt();
 void rta3_wcrt();
 void rta2_wcrt();
 void rta_wcrt();
 int het_workload(int i, int b, int n);
 int het2_workload(int i, int b, int n);
+int heti_workload(int i, int b, int n);
 
 DigitalOut leds[] = { DigitalOut(LED1) = 0,
                       DigitalOut(LED2) = 0,
@@ -203,12 +219,25 @@ struct task_t {
     int a;
     int b;
     int tmc;                   // period - wcet
-    struct method_t methods[6]; // index by METHOD_ID    
+    struct method_t methods[7]; // index by METHOD_ID    
 };
 
 // RTS
 task_t str[NUM_TASKS];
 
+// Frame of the explicit stack used by heti
+struct het_frame {
+    int i;                     // task index
+    int b;                     // time instant
+    int f;                     // floor(b / T_i)
+    int branch0;
+    int branch1;
+    int state;                 // next step to perform
+};
+
+// One frame for each task level
+het_frame het_stack[NUM_TASKS];
+
 typedef void(*fmethod)();
 
 union int_union {
@@ -218,10 +247,11 @@ union int_union {
 
 int num_task = 0;
 int num_rts = 0;
-int rta2_sched, rta3_sched, rta4_sched, rta_sched, het_sched, het2_sched;
-int rta2_usecs, rta3_usecs, rta4_usecs, rta_usecs, het_usecs, het2_usecs;
-int rta2_cycles, rta3_cycles, rta4_cycles, rta_cycles, het_cycles, het2_cycles;
+int rta2_sched, rta3_sched, rta4_sched, rta_sched, het_sched, het2_sched, heti_sched;
+int rta2_usecs, rta3_usecs, rta4_usecs, rta_usecs, het_usecs, het2_usecs, heti_usecs;
+int rta2_cycles, rta3_cycles, rta4_cycles, rta_cycles, het_cycles, het2_cycles, heti_cycles;
 int rta_lsu, rta2_lsu, rta3_lsu, rta4_lsu;
+int stack_used[7];              // bytes of stack used, index by METHOD_ID
 
 // Serial port
 Serial pc(USBTX, USBRX);
@@ -247,6 +277,40 @@ static int getc()
     return int_u.i;
 }
 
+#if MEASURE_STACK == 1
+/*
+ * With probe == 0, fill STACK_PAINT_SIZE bytes of the stack below the caller with
+ * STACK_PATTERN, from the deepest word overwritten since the last call (the words
+ * below it keep the pattern). With probe == 1, return the number of bytes
+ * overwritten since then. Both calls must be made from the same function.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+static int __attribute__((noinline)) stack_paint(int probe)
+{
+    volatile uint32_t buf[STACK_PAINT_SIZE / 4];
+    int i;
+
+    // the stack grows down, so buf[0] is the deepest word
+    for (i = 0; i < STACK_PAINT_SIZE / 4; i++) {
+        if (buf[i] != STACK_PATTERN) {
+            break;
+        }
+    }
+
+    if (probe == 0) {
+        for (; i < STACK_PAINT_SIZE / 4; i++) {
+            buf[i] = STACK_PATTERN;
+        }
+        return 0;
+    }
+
+    return STACK_PAINT_SIZE - i * 4;
+}
+#pragma GCC diagnostic pop
+#endif
+
 static void test_method(fmethod method, int led, int method_id, int *usecs, int *cycles )
 {
     leds[led] = 1;
@@ -261,7 +325,13 @@ static void test_method(fmethod method, int led, int method_id, int *usecs, int
         str[j].a = str[j].c;
         str[j].b = str[j].t;
     }
+    #if MEASURE_STACK == 1
+    stack_paint(0);
+    #endif
     timing( method(), *usecs, *cycles);
+    #if MEASURE_STACK == 1
+    stack_used[method_id] = stack_paint(1);
+    #endif
     leds[led] = 0;
 }
 
@@ -271,6 +341,9 @@ static void send_results(int method_id, int sched, int usecs, int cycles)
     putc(sched);
     putc(usecs);
     putc(cycles);
+    #if MEASURE_STACK == 1
+    putc(stack_used[method_id]);
+    #endif
     #if PRINT_TASK_RESULTS == 1
     #if SUM_CC_LOOPS == 0
     for (int j = 0; j < num_task; j++) {
@@ -360,6 +433,11 @@ int main() {
         #ifdef TEST_HET2
         test_method(het2_wcrt, 1, HET2_ID, &het2_usecs, &het2_cycles);
         #endif
+        
+        // === HETI ===
+        #ifdef TEST_HETI
+        test_method(heti_wcrt, 2, HETI_ID, &heti_usecs, &heti_cycles);
+        #endif
                 
         // write result into serial
         #ifdef TEST_HET
@@ -370,6 +448,10 @@ int main() {
         send_results(HET2_ID, het2_sched, het2_usecs, het2_cycles);
         #endif
         
+        #ifdef TEST_HETI
+        send_results(HETI_ID, heti_sched, heti_usecs, heti_cycles);
+        #endif
+        
         #ifdef TEST_RTA
         send_results(RTA_ID, rta_sched, rta_usecs, rta_cycles);
         #endif
@@ -516,6 +598,105 @@ void het2_wcrt()
     }
     het2_sched = 1;
 }
+
+/*
+ * HETI: workload utility function. Same as het2_workload, but the recursion is
+ * replaced by an explicit stack, with at most one frame for each task level.
+ */
+int heti_workload(int i, int b, int n)
+{
+    int sp = 1;
+    int w = 0;
+
+    het_stack[0].i = i;
+    het_stack[0].b = b;
+    het_stack[0].state = 0;
+
+    while (sp > 0) {
+        struct het_frame *fr = &het_stack[sp - 1];
+        int ci = str[fr->i].c;
+        int ti = str[fr->i].t;
+
+        switch (fr->state) {
+            case 0: {
+                #if PRINT_TASK_RESULTS == 1
+                str[n].methods[HETI_ID].loops += 1;
+                #endif
+
+                fr->f = U_FLOOR( fr->b, ti );
+                int c = U_CEIL( fr->b, ti );
+
+                #if PRINT_TASK_RESULTS == 1
+                str[n].methods[HETI_ID].cc = str[n].methods[HETI_ID].cc + 2;
+                #endif
+
+                fr->branch0 = fr->b - fr->f * (ti - ci);
+                fr->branch1 = c * ci;
+
+                if (fr->i == 0) {
+                    break;
+                }
+
+                int tmp = fr->f * ti;
+                if (tmp > str[fr->i - 1].methods[HETI_ID].last_psi) {
+                    fr->state = 1;
+                    het_stack[sp].i = fr->i - 1;
+                    het_stack[sp].b = tmp;
+                    het_stack[sp].state = 0;
+                    sp = sp + 1;
+                    continue;
+                }
+
+                w = str[fr->i - 1].methods[HETI_ID].last_workload;
+            }
+            // fall through
+            case 1:
+                fr->branch0 = fr->branch0 + w;
+                fr->state = 2;
+                het_stack[sp].i = fr->i - 1;
+                het_stack[sp].b = fr->b;
+                het_stack[sp].state = 0;
+                sp = sp + 1;
+                continue;
+            case 2:
+                fr->branch1 = fr->branch1 + w;
+                break;
+        }
+
+        str[fr->i].methods[HETI_ID].last_psi = fr->b;
+        if (fr->branch0 <= fr->branch1) {
+            str[fr->i].methods[HETI_ID].last_workload = fr->branch0;
+        } else {
+            str[fr->i].methods[HETI_ID].last_workload = fr->branch1;
+        }
+
+        w = str[fr->i].methods[HETI_ID].last_workload;
+        sp = sp - 1;
+    }
+
+    return w;
+}
+
+/*
+ * HET -- improved, without recursion.
+ */
+void heti_wcrt()
+{
+    int i;
+    str[0].methods[HETI_ID].wcrt = str[0].d - str[0].c;
+    
+    for (i = 1; i < num_task; i++) {
+        int c = str[i].c;
+        int d = str[i].d;
+        int w = heti_workload(i - 1, d, i);
+        if ((w + c) > d) {
+            heti_sched = 0;
+            return;
+        }
+        str[i].methods[HETI_ID].wcrt = w + c;
+    }
+    heti_sched = 1;
+}
 /* ------------------------------------------------------------------------- */
 
 /*
@@ -0,0 +1,15 @@
+import numpy as np
+from setuptools import setup, Extension
+
+# Python module with the methods of wcrt-test-sim.c (see wcrtmodule.c)
+wcrt = Extension("wcrt",
+                 sources=["wcrtmodule.c"],
+                 depends=["wcrt-test-sim.c", "wcrt-auto.h"],
+                 include_dirs=[np.get_include(), "/usr/include/libxml2"],
+                 libraries=["xml2", "gsl", "gslcblas", "m", "z"],
+                 extra_compile_args=["-fopenmp"],
+                 extra_link_args=["-fopenmp"])
+
+setup(name="wcrt",
+      description="Schedulability analysis methods of wcrt-test-sim.",
+      ext_modules=[wcrt])
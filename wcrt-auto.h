@@ -0,0 +1,29 @@
+/*
+ * Generated by wcrt-auto.py on 18/10/2026. Do not edit.
+ * Training data: 87 file(s), 17400 rts.
+ * Method with the lowest median time, by harmonic periods, number of tasks,
+ * utilization and period ratio (max T / min T). A value is in the first bucket
+ * whose limit is greater than or equal to it, or in the last one.
+ */
+#define AUTO_N_BUCKETS      4
+#define AUTO_U_BUCKETS      4
+#define AUTO_RATIO_BUCKETS  3
+
+static const double auto_n_limits[AUTO_N_BUCKETS] = {10, 25, 50, 100};
+static const double auto_u_limits[AUTO_U_BUCKETS] = {0.6, 0.8, 0.9, 1.0};
+static const double auto_ratio_limits[AUTO_RATIO_BUCKETS] = {10, 100, 1000};
+
+static const int auto_table[2][AUTO_N_BUCKETS][AUTO_U_BUCKETS][AUTO_RATIO_BUCKETS] = {
+    {  // harmonic = 0: 8800 rts, 17 empty cells
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA_ID}, {RTA4_ID, RTA4_ID, RTA_ID}},  // n <= 10
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA_ID}},  // n <= 25
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 50
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 100
+    },
+    {  // harmonic = 1: 8600 rts, 17 empty cells
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 10
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 25
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 50
+        {{RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}, {RTA4_ID, RTA4_ID, RTA4_ID}},  // n <= 100
+    },
+};
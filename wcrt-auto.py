@@ -0,0 +1,130 @@
+from __future__ import print_function
+
+import sys
+import csv
+import datetime as dt
+import numpy as np
+from argparse import ArgumentParser
+
+
+def read_features(files):
+    """ Read the features files written by wcrt-test-sim --features. Empty files (rejected runs) are skipped """
+    rows = []
+    methods = None
+    sources = []
+    for features_file in files:
+        with open(features_file) as f:
+            reader = csv.DictReader(f)
+            if reader.fieldnames is None:
+                print("{0}: empty, skipped.".format(features_file), file=sys.stderr)
+                continue
+            file_methods = [c[:-len("_nsecs")] for c in reader.fieldnames if c.endswith("_nsecs")]
+            if methods is None:
+                methods = file_methods
+            elif methods != file_methods:
+                print("{0}: methods {1}, expected {2}.".format(features_file, file_methods, methods), file=sys.stderr)
+                sys.exit(1)
+            rows.extend(reader)
+            sources.append(features_file)
+
+    features = {k: np.array([float(r[k]) for r in rows]) for k in ["n", "u", "ratio", "harmonic"]}
+    nsecs = np.array([[float(r[m + "_nsecs"]) for m in methods] for r in rows])
+
+    return methods, features, nsecs, sources
+
+
+def bucket(x, limits):
+    """ Same as auto_bucket in wcrt-test-sim.c """
+    b = np.searchsorted(np.array(limits), x, side="left")
+    return np.minimum(b, len(limits) - 1)
+
+
+def train(methods, features, nsecs, n_limits, u_limits, ratio_limits):
+    """ Method with the lowest median time in each cell. Empty cells use the best method overall """
+    best_all = int(np.argmin(np.median(nsecs, axis=0)))
+
+    nb = bucket(features["n"], n_limits)
+    ub = bucket(features["u"], u_limits)
+    rb = bucket(features["ratio"], ratio_limits)
+    hb = features["harmonic"].astype(int)
+
+    table = np.full((2, len(n_limits), len(u_limits), len(ratio_limits)), best_all, dtype=int)
+    count = np.zeros(table.shape, dtype=int)
+
+    for h in range(2):
+        for n in range(len(n_limits)):
+            for u in range(len(u_limits)):
+                for r in range(len(ratio_limits)):
+                    sel = (hb == h) & (nb == n) & (ub == u) & (rb == r)
+                    count[h, n, u, r] = sel.sum()
+                    if sel.any():
+                        table[h, n, u, r] = int(np.argmin(np.median(nsecs[sel], axis=0)))
+
+    return table, count
+
+
+def c_list(values):
+    return ", ".join(str(v) for v in values)
+
+
+def write_header(header_file, methods, table, count, n_limits, u_limits, ratio_limits, sources):
+    """ Write the table as a C header, with the method ids as the macros of wcrt-test-sim.c """
+    ids = [m.upper() + "_ID" for m in methods]
+
+    with open(header_file, "w") as f:
+        f.write("/*\n")
+        f.write(" * Generated by wcrt-auto.py on {0}. Do not edit.\n".format(dt.datetime.now().strftime("%d/%m/%Y")))
+        f.write(" * Training data: {0} file(s), {1} rts.\n".format(len(sources), count.sum()))
+        f.write(" * Method with the lowest median time, by harmonic periods, number of tasks,\n")
+        f.write(" * utilization and period ratio (max T / min T). A value is in the first bucket\n")
+        f.write(" * whose limit is greater than or equal to it, or in the last one.\n")
+        f.write(" */\n")
+        f.write("#define AUTO_N_BUCKETS      {0}\n".format(len(n_limits)))
+        f.write("#define AUTO_U_BUCKETS      {0}\n".format(len(u_limits)))
+        f.write("#define AUTO_RATIO_BUCKETS  {0}\n\n".format(len(ratio_limits)))
+        f.write("static const double auto_n_limits[AUTO_N_BUCKETS] = {{{0}}};\n".format(c_list(n_limits)))
+        f.write("static const double auto_u_limits[AUTO_U_BUCKETS] = {{{0}}};\n".format(c_list(u_limits)))
+        f.write("static const double auto_ratio_limits[AUTO_RATIO_BUCKETS] = {{{0}}};\n\n".format(c_list(ratio_limits)))
+        f.write("static const int auto_table[2][AUTO_N_BUCKETS][AUTO_U_BUCKETS][AUTO_RATIO_BUCKETS] = {\n")
+        for h in range(2):
+            f.write("    {{  // harmonic = {0}: {1} rts, {2} empty cells\n".format(h, count[h].sum(), (count[h] == 0).sum()))
+            for n in range(len(n_limits)):
+                cells = ["{{{0}}}".format(c_list(ids[table[h, n, u, r]] for r in range(len(ratio_limits))))
+                         for u in range(len(u_limits))]
+                f.write("        {{{0}}},  // n <= {1}\n".format(", ".join(cells), n_limits[n]))
+            f.write("    },\n")
+        f.write("};\n")
+
+
+def get_args():
+    """ Command line arguments """
+    parser = ArgumentParser(description="Generate the wcrt-auto.h header used by the auto method of wcrt-test-sim, " +
+                                        "from the files written with wcrt-test-sim --features.")
+    parser.add_argument("files", help="Features file(s).", nargs="+", type=str)
+    parser.add_argument("--out", help="Header file.", type=str, default="wcrt-auto.h")
+    parser.add_argument("--methods", help="Candidate methods (default: all in the files, except auto).", nargs="+")
+    parser.add_argument("--n-limits", help="Upper limits of the number of tasks buckets.", nargs="+", type=float,
+                        default=[10, 25, 50, 100])
+    parser.add_argument("--u-limits", help="Upper limits of the utilization buckets.", nargs="+", type=float,
+                        default=[0.6, 0.8, 0.9, 1.0])
+    parser.add_argument("--ratio-limits", help="Upper limits of the period ratio buckets.", nargs="+", type=float,
+                        default=[10, 100, 1000])
+    return parser.parse_args()
+
+
+def main():
+    args = get_args()
+
+    methods, features, nsecs, sources = read_features(args.files)
+
+    candidates = args.methods if args.methods else [m for m in methods if m != "auto"]
+    cols = [methods.index(m) for m in candidates]
+
+    table, count = train(candidates, features, nsecs[:, cols], args.n_limits, args.u_limits, args.ratio_limits)
+    write_header(args.out, candidates, table, count, args.n_limits, args.u_limits, args.ratio_limits, sources)
+
+    print("{0} written ({1} rts, {2} empty cells).".format(args.out, count.sum(), (count == 0).sum()))
+
+
+if __name__ == '__main__':
+    main()
@@ -14,13 +14,20 @@ import mbed_lstools
 import subprocess
 import json
 import shutil
+import pickle
+import time
 from bunch import Bunch, unbunchify
 from pyOCD.board import MbedBoard
 from time import sleep
 from argparse import ArgumentParser
+import wcrt_sketch
 
 
-def test_rts_in_mbed(rts, ser, methods, task_metric=None):
+# method names by method id, as in main_wcrt.cpp
+MBED_METHODS = ["het", "het2", "rta", "rta2", "rta3", "rta4", "heti"]
+
+
+def test_rts_in_mbed(rts, ser, methods, task_metric=None, measure_stack=False):
     # send task count
     ser.write(struct.pack('>i', len(rts)))
 
@@ -32,10 +39,13 @@ def test_rts_in_mbed(rts, ser, methods, task_metric=None):
 
     result_str = []
 
+    # number of values sent before the per task metrics
+    head_len = 5 if measure_stack else 4
+
     # retrieve the results
     for _ in methods:
-        # read method, schedulable, usecs and cycles
-        r_str = [ser.read(4) for _ in range(4)]
+        # read method, schedulable, usecs, cycles and stack bytes (if measured)
+        r_str = [ser.read(4) for _ in range(head_len)]
         if task_metric:
             if task_metric == "detail":
                 for _ in rts:
@@ -55,11 +65,10 @@ def test_rts_in_mbed(rts, ser, methods, task_metric=None):
     result_list = []
 
     for r_str in result_str:
-        result = [ struct.unpack('>i', r_str[0])[0], struct.unpack('>i', r_str[1])[0],
-                   struct.unpack('>i', r_str[2])[0], struct.unpack('>i', r_str[3])[0] ]
+        result = [struct.unpack('>i', r)[0] for r in r_str[:head_len]]
 
         # verify that the method id is valid
-        if result[0] not in range(6):
+        if result[0] not in range(7):
             print("Error: invalid method id {0}".format(result[0]), file=sys.stderr)
             return False, None
         
@@ -71,13 +80,13 @@ def test_rts_in_mbed(rts, ser, methods, task_metric=None):
         if task_metric is not None:
             if task_metric == "detail":
                 # wcrt, number of ceils/floors operations and amount of loops per task
-                for r in r_str[4:]:
+                for r in r_str[head_len:]:
                     result.append(struct.unpack('>i', r)[0])
                     
             if task_metric == "total":
                 # total ceil/floor operations and total for/while loops count
-                result.append(struct.unpack('>i', r_str[4])[0])
-                result.append(struct.unpack('>i', r_str[5])[0])
+                result.append(struct.unpack('>i', r_str[head_len])[0])
+                result.append(struct.unpack('>i', r_str[head_len + 1])[0])
 
         result_list.append(result)
 
@@ -91,19 +100,33 @@ def test_rts_in_mbed(rts, ser, methods, task_metric=None):
     return True, result_list
 
 
-def test_rts(rts, ser, methods, task_metric=None):
+def test_rts(rts, ser, methods, task_metric=None, measure_stack=False, telemetry=None):
     test_ok = False
+    attempts = 0
 
     while not test_ok:
+        if attempts > 0 and telemetry is not None:
+            telemetry.retries += 1
+        attempts += 1
+
+        error = "invalid result"
         try:                        
-            test_ok, result_t = test_rts_in_mbed(rts, ser, methods, task_metric)
+            test_ok, result_t = test_rts_in_mbed(rts, ser, methods, task_metric, measure_stack)
         except serial.SerialTimeoutException as e:
+            error = "timeout"
             print("{0}: {1}".format(e.errno, e.strerror), file=sys.stderr)
         except UnicodeDecodeError as e:
+            error = "decode"
             print("{0}: {1}".format(e.errno, e.strerror), file=sys.stderr)
         except struct.error as e:
+            error = "struct"
             print("struct.error: {0}".format(e), file=sys.stderr)            
                     
+        if not test_ok and telemetry is not None:
+            telemetry.resets += 1
+            telemetry.errors[error] = telemetry.errors.get(error, 0) + 1
+            telemetry.tick()
+
         if not test_ok:
             # reset mbed board and wait half a second
             print("Reset", file=sys.stderr)
@@ -115,9 +138,115 @@ def test_rts(rts, ser, methods, task_metric=None):
     return result_t
 
 
-def test_file_hdfs(g, ser, testcfg):
-    results = []
-    for key in g["keys"]:
+def sketch_results(sketches, result_t, test):
+    """ Add the board cycles, usecs, and cc and loops (if sent) of each method to its sketches """
+    head_len = 5 if test.measure_stack else 4
+
+    for r in result_t:
+        method = MBED_METHODS[r[0]]
+        values = {"usecs": r[2], "cycles": r[3]}
+        if test.task_metric == "total":
+            values["cc"], values["loops"] = r[head_len], r[head_len + 1]
+        if test.task_metric == "detail":
+            values["cc"], values["loops"] = sum(r[head_len + 1::3]), sum(r[head_len + 2::3])
+        for metric, v in values.items():
+            sketches.setdefault((method, metric), wcrt_sketch.Sketch()).add(v)
+
+
+class Telemetry(object):
+    """
+    Progress of the test as JSON lines, written at most every secs seconds:
+    rts tested, their rate, the estimated time remaining (of the rts of the
+    keys read so far), the cumulative usecs and cycles of each method, and
+    the retries and resets of the board. The rts skipped when resuming from
+    a checkpoint are only counted as resumed.
+    """
+
+    def __init__(self, out, secs):
+        self.out = out
+        self.secs = secs
+        self.start = self.last = self.last_rts = time.time()
+        self.rts = 0
+        self.resumed = 0
+        self.total = 0
+        self.retries = 0
+        self.resets = 0
+        self.errors = {}
+        self.cost = {}
+
+    def add(self, result_t):
+        """ Count a tested rts, with the results of each method """
+        self.rts += 1
+        self.last_rts = time.time()
+        for r in result_t:
+            cost = self.cost.setdefault(MBED_METHODS[r[0]], {"usecs": 0, "cycles": 0})
+            cost["usecs"] += r[2]
+            cost["cycles"] += r[3]
+        self.tick()
+
+    def tick(self, done=False):
+        now = time.time()
+        if not done and now - self.last < self.secs:
+            return
+        self.last = now
+
+        elapsed = now - self.start
+        rate = self.rts / elapsed if elapsed > 0 else 0.0
+        eta = (self.total - self.rts) / rate if not done and rate > 0 and self.total > self.rts else 0.0
+        line = {"event": "done" if done else "progress", "elapsed": round(elapsed, 3), "rts": self.rts,
+                "resumed": self.resumed, "total": self.total, "rts_per_sec": round(rate, 3), "eta": round(eta, 3),
+                "since_last_rts": round(now - self.last_rts, 3), "retries": self.retries, "resets": self.resets,
+                "errors": self.errors, "methods": self.cost}
+        self.out.write(json.dumps(line, sort_keys=True) + "\n")
+        self.out.flush()
+
+
+class Checkpoint(object):
+    """
+    Periodic checkpoints of a test: the next rts to test (data group, key and
+    rts in the key), the results of each data group and the sketches, saved
+    with pickle at most every secs seconds.
+    """
+
+    def __init__(self, path, secs, test_config, resume=False):
+        self.path = path
+        self.secs = secs
+        self.last = time.time()
+        self.state = {"config": test_config, "pos": (0, 0, 0), "results": [], "sketches": None}
+
+        if resume:
+            with open(path, "rb") as f:
+                self.state = pickle.load(f)
+            if self.state["config"] != test_config:
+                print("{0}: the checkpoint is not of this test configuration.".format(path), file=sys.stderr)
+                sys.exit(1)
+            print("Resuming from data group {0}, key {1}, rts {2}.".format(*self.state["pos"]))
+
+    def done(self, pos):
+        """ Check if the rts at the position was tested before the checkpoint """
+        return pos < self.state["pos"]
+
+    def update(self, pos):
+        """ Set the next rts to test, and save the checkpoint if secs elapsed since the previous one """
+        self.state["pos"] = pos
+        if time.time() - self.last >= self.secs:
+            self.save()
+
+    def save(self):
+        # write a new file and replace the previous one, so a checkpoint is never left incomplete
+        tmp = self.path + ".tmp"
+        with open(tmp, "wb") as f:
+            pickle.dump(self.state, f, protocol=2)
+        if os.name == "nt" and os.path.isfile(self.path):
+            os.remove(self.path)
+        os.rename(tmp, self.path)
+        self.last = time.time()
+
+
+def test_file_hdfs(g, ser, testcfg, sketches=None, keep_rows=True, results=None, ckpt=None, gi=0, telemetry=None):
+    if results is None:
+        results = []
+    for ki, key in enumerate(g["keys"]):
         try:
             # retrieve the selected data from the store
             df = pd.read_hdf(g.file, key, where=g.where, mode='r')
@@ -126,16 +255,36 @@ def test_file_hdfs(g, ser, testcfg):
             dfg = df.groupby(['tdist','trange','ntask','uf','rts_id'])
                 
             print("Ready to test {0} rts from {1}...".format(len(dfg), key))
+
+            if telemetry is not None:
+                telemetry.total += len(dfg)
                 
-            for k, v in dfg:
+            for n, (k, v) in enumerate(dfg):
+                if ckpt is not None and ckpt.done((gi, ki, n)):
+                    if telemetry is not None:
+                        telemetry.total -= 1
+                        telemetry.resumed += 1
+                    continue
+
                 v.columns = [x.upper() for x in v.columns]
                 rts = v.to_dict(orient='records')
-                result_t = test_rts(rts, ser, testcfg.test.methods, testcfg.test.task_metric)
+                result_t = test_rts(rts, ser, testcfg.test.methods, testcfg.test.task_metric, 
+                                    testcfg.test.measure_stack, telemetry)
+
+                if telemetry is not None:
+                    telemetry.add(result_t)
+
+                if sketches is not None:
+                    sketch_results(sketches, result_t, testcfg.test)
+
+                if keep_rows:
+                    for r in result_t:
+                        r.extend([k[3], k[2], k[4]])
+
+                    results.extend(result_t)
 
-                for r in result_t:
-                    r.extend([k[3], k[2], k[4]])
-             
-                results.extend(result_t)
+                if ckpt is not None:
+                    ckpt.update((gi, ki, n + 1))
         except KeyError as e:
             print("{0}".format(e.strerror), file=sys.stderr)
             continue
@@ -152,6 +301,10 @@ def create_df(test, results):
     # column names for the data frame (the csv has no headers)
     col_names = ["method_id", "sched", "usecs", "cycles"]
 
+    # stack bytes used by the method, if measured
+    if test.measure_stack:
+        col_names.append("stack")
+
     # complete columns if the csv has detailed results per task
     if test.task_metric == "detail":
         for n in range(1, test.task_count + 1):
@@ -207,6 +360,7 @@ def build_project(maincfg, testcfg):
                  "METHODS_TO_TEST={0}".format(methods_to_test),
                  "METHODS_IDS={0}".format(method_ids),
                  "PRINT_TASK_RESULTS={0}".format("1" if testcfg.test.task_metric else "0"),
+                 "MEASURE_STACK={0}".format("1" if testcfg.test.measure_stack else "0"),
                  maincfg.test.supported_tests[testcfg.test.test_type]]
     make_call.extend(testcfg.target.project.build_options)
 
@@ -304,6 +458,19 @@ def get_args():
     hdfs_group = parser.add_argument_group('HDF5 store', 'Options for saving the results into a HDF5 store.')
     hdfs_group.add_argument("--reuse-key", help="Replace the DataFrame assigned under key in the store.", default=False, action="store_true")
 
+    sketch_group = parser.add_argument_group('Quantile sketches', 'Options for summarising the results as quantile sketches (see wcrt_sketch.py).')
+    sketch_group.add_argument("--sketch", help="Merge the sketches of the results into file, and print their quantiles.", type=str, metavar="file")
+    sketch_group.add_argument("--sketch-only", help="Do not keep the results of each rts, only the sketches.", default=False, action="store_true")
+
+    ckpt_group = parser.add_argument_group('Checkpoints', 'Options for continuing an interrupted test.')
+    ckpt_group.add_argument("--checkpoint", help="Save the progress and the results of the test into file periodically.", type=str, metavar="file")
+    ckpt_group.add_argument("--checkpoint-secs", help="Time between checkpoints, in secs (default 60).", type=int, default=60)
+    ckpt_group.add_argument("--resume", help="Continue the test from the last checkpoint.", default=False, action="store_true")
+
+    telemetry_group = parser.add_argument_group('Telemetry', 'Options for reporting the progress of the test.')
+    telemetry_group.add_argument("--telemetry", help="Write the progress as JSON lines to file (- for stderr).", type=str, metavar="file")
+    telemetry_group.add_argument("--telemetry-secs", help="Time between telemetry lines, in secs (default 5).", type=float, default=5)
+
     return parser.parse_args()
 
 
@@ -330,6 +497,9 @@ def main():
     if not "test_metric" in test_config["test"].keys():
         test_config["test"]["test_metric"] = False
 
+    if not "measure_stack" in test_config["test"].keys():
+        test_config["test"]["measure_stack"] = False
+
     # parse the configuration files into namespaces
     testcfg = Bunch.fromDict(test_config)
     maincfg = Bunch.fromDict(maincfg_dict)
@@ -358,15 +528,57 @@ def main():
     # dataframe list
     df_list = []
 
+    # sketches by (method, metric), if required
+    sketches = {} if args.sketch else None
+
+    # progress of the test, if required
+    telemetry = None
+    if args.telemetry:
+        telemetry = Telemetry(sys.stderr if args.telemetry == "-" else open(args.telemetry, "w"), args.telemetry_secs)
+
+    # results of each data group, restored from the checkpoint if resuming
+    group_results = []
+    ckpt = None
+    if args.checkpoint:
+        ckpt = Checkpoint(args.checkpoint, args.checkpoint_secs, test_config, args.resume)
+        if args.resume:
+            group_results = ckpt.state["results"]
+            if sketches is not None and ckpt.state["sketches"] is not None:
+                sketches = ckpt.state["sketches"]
+        ckpt.state["results"] = group_results
+        ckpt.state["sketches"] = sketches
+    elif args.resume:
+        print("Error: --resume needs --checkpoint.", file=sys.stderr)
+        exit(1)
+
     # evaluate the given number of rts on the file(s), sending them to the 
     # mbed board, and storing the results as a pandas dataframe.
-    for g in testcfg.test.data:
+    for gi, g in enumerate(testcfg.test.data):
+        if gi == len(group_results):
+            group_results.append([])
         try:
-            df_list.append(create_df(testcfg.test, test_file_hdfs(g, ser, testcfg)))
+            results = test_file_hdfs(g, ser, testcfg, sketches, not args.sketch_only, group_results[gi], ckpt, gi,
+                                     telemetry)
+            if not args.sketch_only:
+                df_list.append(create_df(testcfg.test, results))
         except IOError as e:
             print(e, file=sys.stderr)
             sys.exit(1)
 
+    if ckpt is not None:
+        ckpt.save()
+
+    if telemetry is not None:
+        telemetry.tick(done=True)
+
+    # merge with the sketches already in the file (for example, from other boards)
+    if sketches is not None:
+        wcrt_sketch.print_report(sketches, sys.stderr)
+        wcrt_sketch.update_file(args.sketch, sketches)
+
+    if args.sketch_only:
+        return
+
     # generate a new dataframe
     df = pd.concat(df_list)
 
@@ -10,9 +10,27 @@
 #include <math.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <malloc.h>
 #include <time.h>
 #include <getopt.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <zlib.h>
 #include <gsl/gsl_statistics.h>
+#include <gsl/gsl_sort.h>
+#ifdef USE_HDF5
+#include <hdf5.h>
+#endif
 
 /*
  * Ceil and floor operations without using the library math, when period
@@ -49,7 +67,7 @@
 /*
  * Number of schedulability methods to test.
  */
-#define NUM_SCHED_METHODS 5
+#define NUM_SCHED_METHODS 8
 
 /*
  * Name of the schedulability methods to evaluate.
@@ -59,6 +77,9 @@
 #define RTA2   "rta2"
 #define RTA3   "rta3"
 #define RTA4   "rta4"
+#define HETI   "heti"
+#define AUTO   "auto"
+#define RTA4A  "rta4a"
 
 /*
  * Position of the method in the schedulabilty methods array.
@@ -68,12 +89,247 @@
 #define RTA2_ID   2
 #define RTA3_ID   3
 #define RTA4_ID   4
+#define HETI_ID   5
+#define AUTO_ID   6
+#define RTA4A_ID  7
+
+/*
+ * Method used by auto, by task-set features. Generated by wcrt-auto.py.
+ */
+#include "wcrt-auto.h"
 
 /*
  * Return value for the schedulability methods.
  */
 #define SCHED     1
 #define NON_SCHED 0
+#define SUSPENDED 2     // rta4a_resume ran out of budget
+
+/*
+ * Budget of each call to rta4a_resume.
+ */
+#define BUDGET_CC       0       // ceil operations
+#define BUDGET_ITER     1       // iterations of the inner for loop
+#define BUDGET_NS       2       // nanoseconds
+#define NUM_BUDGET_TYPES 3
+
+/*
+ * Position of the continuation of rta4a_resume, besides a task index of the
+ * inner for loop.
+ */
+#define RTA4A_NEXT      -2      // start the analysis of the next task
+#define RTA4A_WHILE     -1      // test the condition of the while loop
+
+/*
+ * Sufficient tests used to screen the RTS before the exact methods, in the order
+ * they are applied. SCREEN_EXACT means that no bound could settle the RTS.
+ */
+#define SCREEN_EXACT    0       // exact analysis required
+#define SCREEN_UF       1       // U > 1, non schedulable
+#define SCREEN_LL       2       // Liu & Layland bound
+#define SCREEN_HB       3       // hyperbolic bound
+#define SCREEN_RTB      4       // response time upper bound
+#define NUM_SCREEN_TIERS 5
+
+/*
+ * Initial value of the fixpoint iteration of task i.
+ */
+#define SEED_SJODIN     0       // wcrt of task i - 1 plus C_i
+#define SEED_UF         1       // ceil(C_i / (1 - U)), U of the higher priority tasks
+#define SEED_MAX        2       // max of the above
+#define NUM_SEED_TYPES  3
+
+/*
+ * Stack painting, used to measure the stack used by each method.
+ */
+#define STACK_PAINT_SIZE    (256 * 1024)    // bytes painted below the caller
+#define STACK_PATTERN       0xA5            // value of the painted bytes
+
+/*
+ * Count a ceil operation, or an expiry of the window of task j (its
+ * interference grew), in the analysis of task i with method m, if enabled for
+ * the rts under analysis. Only built
+ * with USE_ATTRIBUTION, so the methods are not slowed down otherwise.
+ */
+#ifdef USE_ATTRIBUTION
+#define ATTR_CC(m, i, j)    do { if (rts->attribution == 1) attr_cc[m][(i) * attr_n + (j)] += 1; } while (0)
+#define ATTR_EXP(m, i, j)   do { if (rts->attribution == 1) attr_exp[m][(i) * attr_n + (j)] += 1; } while (0)
+#else
+#define ATTR_CC(m, i, j)    do { } while (0)
+#define ATTR_EXP(m, i, j)   do { } while (0)
+#endif
+
+/*
+ * Record an update of the wcrt tr of task i from old to new, due to task j,
+ * with method m. j == i is used for the initial value, and for the updates
+ * that do not come from a single task, if enabled for the rts under analysis.
+ * Only built with USE_TRACE.
+ */
+#ifdef USE_TRACE
+#define TRACE(m, i, j, old, new)    do { if (rts->trace == 1 && (old) != (new)) trace_add(m, i, j, old, new, tasks[i]->loops_w[m]); } while (0)
+#else
+#define TRACE(m, i, j, old, new)    do { } while (0)
+#endif
+#define TRACE_BUF_RECS      4096    // records in the buffer of each thread
+#define TRACE_MAGIC         "WCRTTRC1"
+
+/*
+ * Admission control service (--serve). Each request starts with the op and the
+ * name of the task set (length and bytes), followed by the op arguments. All
+ * the values are 32 bit integers in network byte order:
+ *   ADD     C, T, D             -> status, task id
+ *   REMOVE  task id             -> status, number of tasks
+ *   QUERY   method, C, T, D     -> status, sched, cc, n, n x wcrt
+ * ADD inserts the task in DM order. QUERY evaluates the set with the method
+ * (id as in the methods array, one of the exact methods: auto and rta4a are
+ * not valid), adding the task C, T, D if C > 0, without changing the set.
+ * Only rta is exact with deadlines shorter than the periods, so the other
+ * methods are not valid if a task of the set or the new one has D < T. The
+ * wcrt are in priority order, as stored by the method (het and heti store
+ * the workload at the deadline plus C), and are 0 after a task misses its
+ * deadline. The replies are sent in the order of the requests,
+ * and the requests received before a client shuts down its side are answered
+ * before its socket is closed.
+ */
+#define SERVE_ADD           1
+#define SERVE_REMOVE        2
+#define SERVE_QUERY         3
+#define SERVE_OK            0
+#define SERVE_ENOSET        -1      // unknown task set
+#define SERVE_EINVAL        -2      // invalid op or arguments
+#define SERVE_ENOTASK       -3      // unknown task id
+#define SERVE_NAME_LEN      64      // max length of a task set name, including '\0'
+#define SERVE_MAX_CLIENTS   64
+#define SERVE_BUF_LEN       4096    // read buffer of each client, and initial size of its write buffer
+
+/*
+ * Metrics aggregated for each (uf, ntask) bucket and method (--buckets).
+ */
+#define BUCKET_CC           0
+#define BUCKET_LOOPS        1
+#define BUCKET_NSECS        2
+#define NUM_BUCKET_METRICS  3
+
+/*
+ * Quantile sketches of the metrics of each method (--sketch), as in a HDR
+ * histogram: values below 2^SKETCH_SUB_BITS have their own bucket, and each
+ * larger power of two range is split in 2^SKETCH_SUB_BITS buckets, so the
+ * relative error of a quantile is below 2^-SKETCH_SUB_BITS. Sketches are
+ * merged adding the counts of each bucket. The file starts with SKETCH_MAGIC,
+ * SKETCH_SUB_BITS and the number of sketches, and each sketch has the method
+ * and metric names (8 bytes each), count, min, max, the number of non empty
+ * buckets and their (index, count) pairs (see wcrt_sketch.py).
+ */
+#define SKETCH_MAGIC        "WCRTSKT1"
+#define SKETCH_SUB_BITS     7
+#define SKETCH_SUB_COUNT    (1 << SKETCH_SUB_BITS)
+#define SKETCH_BUCKETS      ((64 - SKETCH_SUB_BITS + 1) * SKETCH_SUB_COUNT)
+
+/*
+ * Result cache (--cache). The results of each method with a rts are saved
+ * by a 128 bits hash of the C, T and D of its tasks (in priority order), the
+ * method, its version in method_versions, and the options that change the
+ * counters. The file starts with CACHE_MAGIC and continues with records:
+ * key, number of tasks, schedulability, nsecs, and the wcrt, cc, loops_w and
+ * loops_f of each task. New records are appended, and the last record with a
+ * key replaces the previous ones when the file is loaded.
+ */
+#define CACHE_MAGIC         "WCRTCCH1"
+#define CACHE_MIN_SLOTS     1024    // initial size of the hash table
+
+/*
+ * Checkpoints (--checkpoint). The file starts with CKPT_MAGIC, the enabled
+ * methods, the limit, the options that change the results (--screen,
+ * --seed, --harmonic, --merge, --fail-fast, --verify, --budget and --mem)
+ * and the input file, and a block is appended at each
+ * checkpoint with the results of the rts evaluated since the previous one
+ * (schedulability, cc, loops, nsecs and stack of each method, and the
+ * methods replayed from the cache) and the
+ * counters in ckpt_vars. --resume restores the complete blocks, and the rts
+ * already evaluated are not evaluated again.
+ */
+#define CKPT_MAGIC          "WCRTCKP4"
+#define CKPT_BLOCK_MAGIC    "BLCK"
+#define CKPT_END_MAGIC      "END!"
+#define CKPT_SECS           60      // default time between checkpoints
+
+/*
+ * Telemetry (--telemetry). A JSON object is written in a line every
+ * telemetry_secs secs: the rts evaluated, their rate, the estimated time
+ * remaining and the cumulative cc, loops and nsecs of each method, or the
+ * requests handled and the size of the last batch in --serve mode.
+ */
+#define TELEMETRY_SECS      5       // default time between lines
+
+/*
+ * Adversarial search (--search). Each restart climbs from a random rts,
+ * mutating the utilization, period or deadline of its tasks, and keeps the
+ * rts with the highest cost (cc, loops or nsecs) of the method. The restarts
+ * run in parallel, each one with its own random stream.
+ */
+#define SEARCH_ITERS        1000    // default iterations of each restart
+#define SEARCH_RESTARTS     16      // default number of restarts
+#define SEARCH_NSECS_RUNS   3       // evaluations of each rts with the nsecs objective (the min is used)
+
+/*
+ * Random rts (--search and --generate). Rts k is drawn from the random
+ * stream k of the seed, with a counter based generator, so it does not
+ * depend on the thread that generates it. The rts are generated in parallel
+ * in batches of GEN_BATCH, and evaluated in order.
+ */
+#define GEN_BATCH           256     // rts generated at a time
+#define GEN_UF_TOL          0.005   // max difference between the utilization of the rts (with integer C) and gen_uf
+#define GEN_TRIES           100     // rts drawn until one is within GEN_UF_TOL
+#define RNG_GOLDEN          0x9E3779B97F4A7C15ULL
+
+/*
+ * Columnar results file (--results). The file starts with COL_MAGIC, the
+ * number of methods and their names (8 bytes each), and continues with
+ * chunks of up to COL_CHUNK_ROWS rows of one table. Each chunk has a header
+ * (COL_CHUNK_MAGIC, table, rows, columns) followed by the columns: name
+ * (COL_NAME_LEN bytes), raw and stored size, and the int64 values, zlib
+ * compressed if the stored size is smaller than the raw size. All the integers
+ * are little endian, whatever the byte order of the host. New runs are
+ * appended to an existing file with the same methods (see wcrt_results.py).
+ */
+#define COL_MAGIC           "WCRTCOL1"
+#define COL_CHUNK_MAGIC     "CHNK"
+#define COL_CHUNK_ROWS      65536
+#define COL_NAME_LEN        16
+#define COL_RTS             0       // one row for each rts and method
+#define COL_TASK            1       // one row for each task, rts and method (--detail)
+#define NUM_COL_TABLES      2
+
+/*
+ * HDF5 stores written by pandas (format='table'), as used by wcrt-test-mbed.py.
+ * The rows of the table are read in chunks of HDF5_CHUNK_ROWS, and consecutive
+ * rows with the same HDF5 group columns form a rts, with the tasks in priority
+ * order. The where condition is a list of terms 'column op value' joined with
+ * '&', with op one of == != < <= > >= and value a number or a quoted string.
+ */
+#define HDF5_CHUNK_ROWS     8192
+#define HDF5_NUM_COLS       8
+#define HDF5_NUM_GROUP      5       // the first columns are the rts group
+#define HDF5_MAX_TERMS      16
+#define HDF5_STR_LEN        64
+#define HDF5_COL_C          5
+#define HDF5_COL_T          6
+#define HDF5_COL_D          7
+
+/*
+ * Results store (--store), a pandas table with the columns of the results of
+ * wcrt-test-mbed.py (task_metric "total"), so generate-xls.py can report on
+ * both. The method ids are the ones of main-config-tmpl.json, and the cycles
+ * column has the nanoseconds used by the method.
+ */
+#define STORE_NUM_COLS      9
+#define STORE_CHUNK_ROWS    4096
+#define STORE_DEFLATE       9
+
+/*
+ * Number of interferers listed in the ranking of each RTS, in attribution mode.
+ */
+#define ATTR_HOT            5
 
 /*
  * Global variables.
@@ -81,6 +337,171 @@
 int rts_founded = 0;        // Number of RTS in the XML file evaluated.
 int verbose = 0;            // Print addtional info to stderr
 FILE* out_file;             // Result file
+int param_task = -1;        // Task whose wcet is the parameter of the parametric RTA (-1: disabled)
+int param_lo = 0;           // Lower end of the C range for the parametric RTA (0: task wcet)
+int param_hi = 0;           // Upper end of the C range for the parametric RTA (0: task deadline)
+int opa = 0;                // Compute an optimal priority assignment (Audsley) for each RTS
+int opa_sched_cnt = 0;      // Number of RTS schedulable with the OPA
+long opa_cc = 0;            // Number of ceil operations performed by the OPA oracle
+int screen = 0;             // Screen the RTS with sufficient tests before the exact methods
+int screen_cnt[NUM_SCREEN_TIERS];   // Number of RTS decided by each screening tier
+int seed_type = SEED_SJODIN;        // Initial value used by the RTA methods
+long seed_while[2][NUM_SCHED_METHODS];  // while loops with the default [0] and selected [1] seed
+long seed_cc[2][NUM_SCHED_METHODS];     // ceil operations with the default [0] and selected [1] seed
+char *seed_names[NUM_SEED_TYPES] = {"sjodin", "uf", "max"};
+int harmonic = 0;           // Use the closed form for harmonic RTS
+int merge = 0;              // Merge runs of equal period tasks
+int harmonic_cnt = 0;       // Number of RTS evaluated with the harmonic closed form
+char *settled = NULL;       // RTS decided by the screen or the closed form, by index (the methods did not run)
+int32_t *cached = NULL;     // Methods replayed from the cache, by index (bit method_id, their nsecs were not measured)
+int settled_cnt = 0;        // Number of RTS settled
+long harmonic_cc = 0;       // Number of ceil operations performed by the closed form
+int merged_cnt = 0;         // Number of RTS with equal period tasks merged
+int merged_tasks = 0;       // Number of tasks removed by merging
+long chains_sum = 0;        // Sum of the number of harmonic chains of each RTS
+int fail_fast = 0;          // Try to find first the task that misses its deadline
+int fail_fast_verify = 0;   // Evaluate the methods also with the RTS found non schedulable by the fail-fast test
+int fail_fast_cnt = 0;      // Number of RTS found non schedulable by the fail-fast test
+int fail_fast_missed = 0;   // Number of RTS not schedulable, but not found by the fail-fast test (with verify)
+long fail_fast_cc = 0;      // Number of ceil operations performed by the fail-fast test
+long fail_fast_saved[NUM_SCHED_METHODS];    // ceil operations of each method in the RTS found by the fail-fast test
+int mem = 0;                // Measure the stack and heap used by each method
+int attribution = 0;        // Count the ceil operations and window expiries of each (i, j) pair
+FILE* attr_file;            // Attribution file
+int attr_n = 0;             // Size of the attribution counters (max number of tasks)
+int *attr_cc[NUM_SCHED_METHODS];    // ceil operations of task i caused by task j, at i * attr_n + j
+int *attr_exp[NUM_SCHED_METHODS];   // window expiries of task j in the analysis of task i
+long *level_cc[NUM_SCHED_METHODS];  // ceil operations caused by the task in each priority level
+long *level_exp[NUM_SCHED_METHODS]; // window expiries of the task in each priority level
+double hot_share[NUM_SCHED_METHODS];    // sum of the share of the ceil operations due to the top interferer
+FILE* features_file;        // Features and cost of each RTS, used to train the auto method (NULL: disabled)
+int nsecs = 0;              // Print the time used by each method
+int auto_cnt[NUM_SCHED_METHODS];    // Number of RTS dispatched to each method by auto
+int budget_type = BUDGET_CC;        // Budget type of each rta4a_resume call
+long budget = 0;                    // Budget of each rta4a_resume call (0: unbounded)
+char *budget_names[NUM_BUDGET_TYPES] = {"cc", "iter", "ns"};
+long rta4a_slices = 0;      // Number of rta4a_resume calls
+int rta4a_slices_max = 0;   // Max number of rta4a_resume calls for a RTS
+char *serve_path = NULL;    // Unix socket of the admission control service (NULL: disabled)
+int serve_batch = 1;        // Time window of a batch of requests, in msecs
+volatile sig_atomic_t serve_stop = 0;   // Set by SIGINT and SIGTERM
+FILE* buckets_file = NULL;  // Metrics of each (uf, ntask) bucket (NULL: disabled)
+struct bucket_t *buckets = NULL;
+int num_buckets = 0;
+char *metric_names[NUM_BUCKET_METRICS] = {"cc", "loops", "nsecs"};
+char *sketch_path = NULL;   // Quantile sketches file (NULL: disabled)
+
+// quantile sketch of a metric
+struct sketch_t {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t *counts;           // SKETCH_BUCKETS counters (NULL: empty sketch)
+};
+
+// sketches of each method and metric
+struct sketch_t sketches[NUM_SCHED_METHODS][NUM_BUCKET_METRICS];
+
+// sketch of a sketches file, with its method and metric names
+struct saved_sketch_t {
+    char names[2][8];
+    struct sketch_t sk;
+};
+
+FILE* cache_file = NULL;    // Result cache (NULL: disabled)
+int no_cache = 0;           // Evaluate the methods even if their results are in the cache
+long cache_hits = 0;        // Number of results read from the cache
+long cache_misses = 0;      // Number of results evaluated and saved into the cache
+
+// cached results of a method with a rts
+struct cache_rec {
+    uint64_t key[2];
+    int32_t ntask;
+    int32_t sched;
+    double nsecs;
+    int32_t *tasks;             // wcrt, cc, loops_w and loops_f of each task
+};
+
+struct cache_rec *cache_recs = NULL;
+long cache_len = 0;
+long *cache_slots = NULL;   // hash table of indexes into cache_recs (-1: empty slot)
+long cache_num_slots = 0;
+
+FILE* ckpt_file = NULL;     // Checkpoints file (NULL: disabled)
+int ckpt_secs = CKPT_SECS;  // Time between checkpoints, in secs
+int ckpt_resume = 0;        // Continue from the last checkpoint
+int ckpt_resumed = 0;       // Number of rts restored from the checkpoints
+int ckpt_first = 0;         // First rts of the next block
+int ckpt_len = 0;           // Number of rts of the next block
+int ckpt_size = 0;
+char *ckpt_rows = NULL;     // Rows of the rts resumed, and of the next block
+struct timespec ckpt_last;  // Time of the last checkpoint
+FILE* telemetry_file = NULL;    // Telemetry lines (NULL: disabled)
+int telemetry_secs = TELEMETRY_SECS;    // Time between telemetry lines, in secs
+int telemetry_limit = 0;        // Number of rts to evaluate
+struct timespec telemetry_start;    // Start of the run
+struct timespec telemetry_last;     // Time of the last telemetry line
+double telemetry_cost[NUM_SCHED_METHODS][NUM_BUCKET_METRICS];  // cumulative cc, loops and nsecs of each method
+long telemetry_reqs = 0;        // Number of requests handled in --serve mode
+long telemetry_batches = 0;     // Number of batches handled in --serve mode
+char *search_spec = NULL;   // Method and objective of the adversarial search, as method:metric (NULL: disabled)
+int search_iters = SEARCH_ITERS;        // Iterations of each restart
+int search_restarts = SEARCH_RESTARTS;  // Number of restarts
+int gen_ntask = 10;         // Number of tasks of the random rts
+int gen_uf = 90;            // Utilization of the random rts, in %
+int gen_tmin = 25;          // Range of the log-uniform periods of the random rts
+int gen_tmax = 1000;
+int gen_constrained = 0;    // Deadlines uniform in [C, T] (0: implicit, D = T)
+int gen_harmonic = 0;       // Periods rounded down to gen_tmin * 2^k
+uint64_t gen_seed = 1;      // Seed of the random streams
+int generate = 0;           // Evaluate random rts instead of the rts of a file
+
+// counter based random stream: the n-th value depends only on key and n
+struct rng_t {
+    uint64_t key;
+    uint64_t ctr;
+};
+
+// task of a random rts
+struct gen_task {
+    double u;
+    int c;
+    int t;
+    int d;
+};
+
+// version of each method, increment it when the results or counters of the method change
+const int method_versions[NUM_SCHED_METHODS] = {1, 1, 1, 1, 1, 1, 1, 1};
+
+FILE* col_file = NULL;      // Columnar results file (NULL: disabled)
+int col_detail = 0;         // Write the results of each task into col_file
+int col_level = 0;          // zlib compression level of col_file (0: not compressed)
+int64_t col_run = 0;        // Run id (start time in usecs) of the rows in col_file
+char *store_path = NULL;    // HDF5 store for the results (NULL: disabled)
+char *store_key = "/sim";   // Key of the results in the store
+char *hdf5_key = NULL;      // Key of the rts table in a HDF5 store (NULL: read a XML file)
+char *hdf5_where = NULL;    // Condition of the rows read from the HDF5 store
+int trace = 0;              // Record the updates of tr into the trace file
+FILE* trace_file;           // Trace file
+long trace_cnt = 0;         // Number of records written in the trace file
+
+// trace record, in the byte order of the host
+struct trace_rec {
+    int32_t rts_id;
+    int32_t old_tr;
+    int32_t new_tr;
+    uint16_t i;
+    uint16_t j;
+    uint16_t iter;              // while loop of task i
+    uint8_t method;
+    uint8_t pad;
+};
+
+// trace buffer and current rts of each thread
+struct trace_rec trace_buf[TRACE_BUF_RECS];
+int trace_len = 0;
+int trace_rts = 0;
+#pragma omp threadprivate(trace_buf, trace_len, trace_rts)
 
 // Tarea
 struct task_t {
@@ -99,8 +520,13 @@ struct task_t {
     int b_rta3;
     int a_rta4;
     int b_rta4;
+    int a_rta4a;
+    int b_rta4a;
     int last_psi;                   // used by het -- last time instant evaluated
     int last_workload;              // used by het -- last workload   
+    int heti_psi;                   // used by heti -- last time instant evaluated
+    int heti_workload;              // used by heti -- last workload
+    double u_hp;                    // utilization of the higher priority tasks
 };
 
 // rts
@@ -110,6 +536,11 @@ struct rts_t {
     int rts_ntask;
     int *schedulable;
     struct task_t **tasks;    
+    int harmonic;               // all periods are harmonic, and the tasks in RM order
+    int chains;                 // number of harmonic chains of periods (only reported)
+    int auto_method;            // method selected by auto
+    int trace;                  // record the updates of tr of this evaluation (TRACE)
+    int attribution;            // count the ceil operations of this evaluation (ATTR_CC, ATTR_EXP)
 };
 
 // set of rts
@@ -120,6 +551,120 @@ struct set_t {
     struct rts_t **rts_list;
 };
 
+// continuation of rta4a
+struct rta4_cont {
+    int i;                      // task under analysis
+    int j;                      // next task of the inner for loop, RTA4A_NEXT or RTA4A_WHILE
+    int tr;                     // wcrt of task i
+    int min_i;                  // min b of the tasks up to i
+};
+
+// client of the admission control service
+struct serve_client {
+    int fd;
+    char *in;                   // bytes read, not parsed yet
+    int in_len;
+    char *out;                  // replies not sent yet
+    int out_len;
+    int out_size;
+    int eof;                    // the client shut down its side, close after sending the replies
+};
+
+// task set resident in the admission control service
+struct named_set {
+    char name[SERVE_NAME_LEN];
+    int n;
+    int size;                   // reserved tasks
+    int next_id;
+    int *id;
+    int *c;
+    int *t;
+    int *d;
+};
+
+#ifdef USE_HDF5
+// results table of the store
+struct store_t {
+    hid_t file;
+    hid_t group;
+    hid_t table;
+    hid_t row_type;
+    hsize_t nrows;              // rows written
+    int len;                    // rows in buf
+    int64_t buf[STORE_CHUNK_ROWS][STORE_NUM_COLS + 1];  // index and values
+};
+
+// column of a HDF5 table
+struct hdf5_col {
+    char name[HDF5_STR_LEN];
+    long offset;                // offset in the row (-1: the table has no such column)
+    H5T_class_t type_class;
+    size_t size;
+    H5T_sign_t sign;
+};
+
+// term of a where condition
+struct hdf5_term {
+    struct hdf5_col col;
+    char op[3];
+    double value;
+    char str[HDF5_STR_LEN];
+    int is_str;
+};
+#endif
+
+// running statistics of a metric: Welford mean and variance, and the P2
+// median estimate ("The P2 algorithm for dynamic calculation of quantiles
+// and histograms without storing observations", Jain and Chlamtac, 1985)
+struct stats_t {
+    long n;
+    double mean;
+    double m2;
+    double min;
+    double max;
+    double q[5];                // P2 markers (the first 5 values until n == 5)
+    double pos[5];              // positions of the markers
+    double want[5];             // desired positions of the markers
+};
+
+// metrics of a (uf, ntask) bucket
+struct bucket_t {
+    int uf;
+    int ntask;
+    long count;
+    long sched[NUM_SCHED_METHODS];
+    struct stats_t stats[NUM_SCHED_METHODS][NUM_BUCKET_METRICS];
+};
+
+// table of the columnar results file
+struct col_table {
+    int ncols;
+    const char **names;
+    int nrows;
+    int64_t *data;              // ncols columns of COL_CHUNK_ROWS values, little endian
+};
+
+// request of the admission control service
+struct serve_req {
+    int fd;                     // client
+    int op;
+    char name[SERVE_NAME_LEN];
+    int arg[4];
+    int status;
+    int sched;
+    int cc;
+    int n;
+    int *wcrt;                  // QUERY only, n values
+};
+
+// task-set features used by auto
+struct features_t {
+    int n;                      // number of tasks
+    double u;                   // utilization
+    double ratio;               // max period / min period
+    int harmonic;               // each period divides the period of the next task
+};
+
 // prototipe for scheduling analysis methods
 typedef int (*sched_test_method) (struct rts_t*);
 
@@ -131,6 +676,13 @@ struct result_t {
     double cc_std;
     double loops_mean;
     double loops_std;
+    double *nsecs;              // time used, in nanoseconds
+    double nsecs_mean;
+    double nsecs_std;
+    double *stack;              // stack used, in bytes
+    double stack_mean;
+    long stack_max;
+    long heap_max;              // heap growth across the call, in bytes
 };
 
 struct method_t {
@@ -138,16 +690,127 @@ struct method_t {
     int method_id;
     sched_test_method method;
     struct result_t *result;
+    int enabled;                // evaluate this method
+};
+
+// frame of the explicit stack used by heti
+struct het_frame {
+    int i;                      // task index
+    int b;                      // time instant
+    int f;                      // floor(b / T_i)
+    int branch0;
+    int branch1;
+    int state;                  // next step to perform
 };
 
 /*
  * Prototipes
  */
+int rta_seed(struct task_t**, int i, int t);
+void trace_add(int m, int i, int j, int old_tr, int new_tr, int iter);
+void trace_flush();
 int rta_wcrt(struct rts_t*);
 int rta2_wcrt(struct rts_t*);
 int rta3_wcrt(struct rts_t*);
+int rta4_wcrt(struct rts_t*);
+void rta4a_init(struct rts_t*, struct rta4_cont*);
+int rta4a_resume(struct rts_t*, struct rta4_cont*, int budget_type, long budget);
+int rta4a_wcrt(struct rts_t*);
 int het_workload(int i, int b, int n, struct task_t**);
 int het_wcrt(struct rts_t*);
+int heti_workload(int i, int b, int n, struct task_t**, struct het_frame*);
+int heti_wcrt(struct rts_t*);
+void rts_features(struct rts_t*, struct features_t*);
+int auto_select(struct rts_t*);
+int auto_wcrt(struct rts_t*);
+void reset_method(struct rts_t*, int m);
+int rta_param(struct rts_t*, int k, int lo, int hi, FILE *f);
+int rta4_task_test(struct task_t**, int *hp, int nhp, int x, int *a, int *b, int *cc);
+int opa_assign(struct rts_t*, int *order, long *cc);
+int screen_rts(struct rts_t*, int *sched);
+void reset_rts(struct rts_t*);
+void reset_tasks(struct rts_t*);
+void attr_reset(int n);
+void attr_report(struct rts_t*, struct method_t*);
+void evaluate_rts(struct rts_t*, struct method_t*, int idx);
+void testRts(struct rts_t*, struct method_t*);
+void result_stats(struct method_t*, int num_rts);
+void stats_add(struct stats_t*, double x);
+double stats_median(struct stats_t*);
+void bucket_add(struct rts_t*, struct method_t*, int idx);
+void bucket_report(struct method_t*);
+int sketch_index(uint64_t v);
+uint64_t sketch_value(int index);
+void sketch_add(struct sketch_t*, uint64_t v, uint64_t count);
+void sketch_merge(struct sketch_t*, struct sketch_t*);
+uint64_t sketch_quantile(struct sketch_t*, double q);
+void sketch_rts(struct method_t*, int idx);
+struct sketch_t *sketch_find(struct saved_sketch_t **saved, int *num_saved, char names[2][8]);
+int sketch_load(char *path, struct saved_sketch_t **saved);
+void sketch_save(char *path, struct saved_sketch_t *saved, int num_saved);
+void sketch_update(char *path, struct method_t*);
+void cache_key(struct rts_t*, int method_id, uint64_t *key);
+struct cache_rec *cache_find(uint64_t *key);
+void cache_insert(struct cache_rec*);
+void cache_open(char *path);
+int cache_replay(struct rts_t*, int method_id, double *nsecs);
+void cache_save(struct rts_t*, int method_id, double nsecs);
+void checkpoint_open(char *path, char *input, int limit, struct method_t*);
+void checkpoint_restore(struct rts_t*, struct method_t*, int idx);
+void checkpoint_add(struct rts_t*, struct method_t*, int idx);
+void checkpoint_write(struct method_t*);
+double telemetry_elapsed(struct timespec *now);
+void telemetry_rts(struct method_t*, int idx, int done);
+void telemetry_batch(int num_reqs, int num_clients, int num_sets);
+const char *col_method_name(struct method_t*);
+uint32_t col_le32(uint32_t v);
+uint64_t col_le64(uint64_t v);
+void col_open(char *path, struct method_t*);
+void col_add(int table, int64_t *row);
+void col_flush(int table);
+void col_rts_rows(struct rts_t*, struct method_t*, int idx);
+int fail_fast_rts(struct rts_t*, int *cc);
+void harmonic_rts(struct rts_t*);
+int harmonic_wcrt(struct rts_t*, long *cc);
+struct rts_t *merge_rts(struct rts_t*);
+void unmerge_rts(struct rts_t*, struct rts_t *merged);
+int analyse_tasks(int n, const int *c, const int *t, const int *d, int method_id, int *wcrt, int *cc, int *loops_w, int *loops_f);
+int serve(char *path);
+uint64_t rng_mix(uint64_t x);
+void rng_init(struct rng_t*, uint64_t seed, uint64_t stream);
+uint64_t rng_next(struct rng_t*);
+double rng_uniform(struct rng_t*);
+void gen_uunifast(struct rng_t*, int n, double u, double *ui);
+int gen_period(struct rng_t*);
+void gen_wcet(struct rng_t*, struct gen_task*);
+void gen_sort(struct gen_task*, int n);
+void gen_rts(struct rng_t*, struct gen_task*);
+double gen_util(struct gen_task*);
+int gen_reachable();
+double search_cost(struct gen_task*, int method_id, int metric, int *sched);
+void search_mutate(struct rng_t*, struct gen_task*);
+int search(char *spec, struct method_t*);
+void testRtsGenerated(struct set_t*, struct method_t*, int limit);
+#ifdef USE_HDF5
+void testRtsInHdf5(char *file, char *key, char *where, struct set_t*, struct method_t*, int limit);
+void store_pickle_add(char **buf, size_t *size, const char *fmt, ...);
+void store_pickle_str(char **buf, size_t *size, const char *str);
+void store_open(char *path, char *key, char *input, int limit, struct method_t*);
+void store_rts_rows(struct rts_t*, struct method_t*, int idx);
+void store_close();
+#endif
+
+/*
+ * Methods, by method id.
+ */
+const sched_test_method method_funcs[NUM_SCHED_METHODS] = {[RTA_ID]   rta_wcrt,
+                                                           [RTA2_ID]  rta2_wcrt,
+                                                           [RTA3_ID]  rta3_wcrt,
+                                                           [RTA4_ID]  rta4_wcrt,
+                                                           [HET_ID]   het_wcrt,
+                                                           [HETI_ID]  heti_wcrt,
+                                                           [AUTO_ID]  auto_wcrt,
+                                                           [RTA4A_ID] rta4a_wcrt};
 
 int het_workload(int i, int b, int n, struct task_t **tasks)
 {
@@ -215,383 +878,4931 @@ int het_wcrt(struct rts_t *rts)
 }
 
 /*
- * RTA
- * "Improved Response-Time Analysis Calculations"
- * http://doi.ieeecomputersociety.org/10.1109/REAL.1998.739773
+ * Iterative version of het_workload. The recursion is replaced by an explicit
+ * stack with one frame for each task level, so at most i + 1 frames are used.
+ * The results and the cc and loops counters are the same as with het_workload.
  */
-int rta_wcrt(struct rts_t *rts)
+int heti_workload(int i, int b, int n, struct task_t **tasks, struct het_frame *stack)
 {
-    struct task_t **tasks = rts->tasks;
-    
-    int w = 0;
-    int tr = 0;
-    int t = tasks[0]->c;
-    tasks[0]->wcrt[RTA_ID] = tasks[0]->c;
+    int sp = 0;
+    int w = 0;      // workload returned by the last popped frame
 
-    int i, j;
-    for (i = 1; i < rts->rts_ntask; i++) {
-        tr = t + tasks[i]->c;
-        tasks[i]->loops_f[RTA_ID] += 1;
+    stack[0].i = i;
+    stack[0].b = b;
+    stack[0].state = 0;
+    sp = 1;
 
-        do {
-            tasks[i]->loops_w[RTA_ID] += 1;
-            t = tr;
-            w = tasks[i]->c;
+    while (sp > 0) {
+        struct het_frame *fr = &stack[sp - 1];
+        struct task_t *task = tasks[fr->i];
 
-            for (j = 0; j < i; j++) {
-                tasks[i]->loops_f[RTA_ID] += 1;
-                
-                int c_j = tasks[j]->c;
-                int t_j = tasks[j]->t;
-                int a = U_CEIL(tr, t_j);
-                tasks[i]->cc[RTA_ID] += 1;
-                
-                w = w + (a * c_j);
-                
-                if (w > tasks[i]->d) {
-                    rts->schedulable[RTA_ID] = NON_SCHED;
-                    return NON_SCHED;
+        switch (fr->state) {
+            case 0: // first visit
+                tasks[n]->loops_w[HETI_ID] += 1;
+
+                fr->f = (int) U_FLOOR(fr->b, task->t);
+                int c = (int) U_CEIL(fr->b, task->t);
+
+                tasks[n]->cc[HETI_ID] += 2;
+
+                fr->branch0 = fr->b - fr->f * (task->t - task->c);
+                fr->branch1 = c * task->c;
+
+                if (fr->i == 0) {
+                    break;
                 }
-            }
-            
-            tr = w;
-        
-        } while (t != tr);
 
-        tasks[i]->wcrt[RTA_ID] = t;
+                int tmp = fr->f * task->t;
+                if (tmp > tasks[fr->i - 1]->heti_psi) {
+                    // workload of the higher priority tasks at f * T_i
+                    fr->state = 1;
+                    stack[sp].i = fr->i - 1;
+                    stack[sp].b = tmp;
+                    stack[sp].state = 0;
+                    sp += 1;
+                    continue;
+                }
+
+                w = tasks[fr->i - 1]->heti_workload;
+                // fall through
+            case 1: // workload at f * T_i in w
+                fr->branch0 += w;
+                fr->state = 2;
+                stack[sp].i = fr->i - 1;
+                stack[sp].b = fr->b;
+                stack[sp].state = 0;
+                sp += 1;
+                continue;
+            case 2: // workload at b in w
+                fr->branch1 += w;
+                break;
+        }
+
+        task->heti_psi = fr->b;
+
+        if (fr->branch0 <= fr->branch1) {
+            task->heti_workload = fr->branch0;
+        } else {
+            task->heti_workload = fr->branch1;
+        }
+
+        w = task->heti_workload;
+        sp -= 1;
     }
-    
-    rts->schedulable[RTA_ID] = SCHED;
-    return SCHED;
+
+    return w;
 }
 
 /*
- * RTA2
- * "Reduced computational cost in the calculation of worst case response time for real time systems"
- * http://sedici.unlp.edu.ar/handle/10915/9654
+ * HET, without recursion. See heti_workload.
  */
-int rta2_wcrt(struct rts_t *rts)
+int heti_wcrt(struct rts_t *rts)
 {
     struct task_t **tasks = rts->tasks;
-
-    int tr = 0;
-    int t = tasks[0]->c;
-    tasks[0]->wcrt[RTA2_ID] = tasks[0]->c;
-
-    int i, j;
+    struct het_frame stack[rts->rts_ntask];
+    
+    int i;
     for (i = 1; i < rts->rts_ntask; i++) {
-        tr = t + tasks[i]->c;
-        tasks[i]->loops_f[RTA2_ID] += 1;
+        tasks[i]->loops_f[HETI_ID] += 1;
 
-        do {
-            tasks[i]->loops_w[RTA2_ID] += 1;
-            t = tr;
+        int w = heti_workload(i - 1, tasks[i]->d, i, tasks, stack);
 
-            for (j = 0; j < i; j++) {
-                tasks[i]->loops_f[RTA2_ID] += 1;
-                
-                int a = U_CEIL(tr, tasks[j]->t);
-                tasks[i]->cc[RTA2_ID] += 1;
-                a = a * tasks[j]->c;
-                
-                if (a > tasks[j]->a_rta2) {
-                    tr = tr + a - tasks[j]->a_rta2;
-                    tasks[j]->a_rta2 = a;
-                    
-                    if (tr > tasks[i]->d) {
-                        rts->schedulable[RTA2_ID] = NON_SCHED;
-                        return NON_SCHED;
-                    }
-                }
-            }
-        } while (t != tr);
-     
-        tasks[i]->wcrt[RTA2_ID] = t;
-    }
+        if ((w + tasks[i]->c) > tasks[i]->d) {
+            rts->schedulable[HETI_ID] = NON_SCHED;
+            return NON_SCHED;
+        }
+        
+        tasks[i]->wcrt[HETI_ID] = w + tasks[i]->c;
+    } 
     
-    rts->schedulable[RTA2_ID] = SCHED;
+    rts->schedulable[HETI_ID] = SCHED;
     return SCHED;
 }
 
 /*
- * RTA3
- * "Computational Cost Reduction for Real-Time Schedulability Tests Algorithms"
- * http://ieeexplore.ieee.org/document/7404899/
+ * Start a new rta4a analysis of the rts.
  */
-int rta3_wcrt(struct rts_t *rts)
+void rta4a_init(struct rts_t *rts, struct rta4_cont *k)
 {
     struct task_t **tasks = rts->tasks;
 
-    int tr = 0;
-    int t = tasks[0]->c;
-    tasks[0]->wcrt[RTA3_ID] = tasks[0]->c;
-
-    int i, j;
-    for (i = 1; i < rts->rts_ntask; i++) {
-        tr = t + tasks[i]->c;
-        tasks[i]->loops_f[RTA3_ID] += 1;
-
-        do {
-            tasks[i]->loops_w[RTA3_ID] += 1;
-            t = tr;
-            
-            for (j = i - 1; j >= 0; j--) {
-                tasks[i]->loops_f[RTA3_ID] += 1;
-            
-                if (tr > tasks[j]->b_rta3) {
-                    int a_t = U_CEIL(tr, tasks[j]->t);
-                    tasks[i]->cc[RTA3_ID] += 1;
-
-                    int a = a_t * tasks[j]->c;
-                    tr = tr + a - tasks[j]->a_rta3;
-
-                    tasks[j]->a_rta3 = a;
-                    tasks[j]->b_rta3 = a_t * tasks[j]->t;
-                    
-                    // verifica vencimiento
-                    if (tr > tasks[i]->d) {
-                        rts->schedulable[RTA3_ID] = NON_SCHED;
-                        return NON_SCHED;
-                    }
-                }
-            }            
-        } while (t != tr);
+    tasks[0]->wcrt[RTA4A_ID] = tasks[0]->c;
 
-        tasks[i]->wcrt[RTA3_ID] = t;
-    }
-    
-    rts->schedulable[RTA3_ID] = SCHED;
-    return SCHED;
+    k->i = 0;
+    k->j = RTA4A_NEXT;
+    k->tr = tasks[0]->c;
+    k->min_i = tasks[0]->b_rta4a;
 }
 
 /*
- * RTA4
+ * RTA4, anytime version. Continue the analysis saved in k until the rts is
+ * found schedulable or not, or until budget is used, in which case the state
+ * is saved back in k and SUSPENDED is returned. Each call performs at least
+ * one iteration of the inner for loop. The state of the analysis is in k and
+ * in the a_rta4a and b_rta4a fields of the tasks, so the rts must not be
+ * changed between calls. With the same rts the counters and wcrt are the
+ * same as with rta4_wcrt (default seed).
  */
-int rta4_wcrt(struct rts_t *rts)
+int rta4a_resume(struct rts_t *rts, struct rta4_cont *k, int budget_type, long budget)
 {
     struct task_t **tasks = rts->tasks;
 
-    int tr = tasks[0]->c;
-    tasks[0]->wcrt[RTA4_ID] = tasks[0]->c;
+    int i = k->i;
+    int j = k->j;
+    int tr = k->tr;
+    int min_i = k->min_i;
+    long used = 0;
+
+    struct timespec start, now;
+    if (budget_type == BUDGET_NS) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+
+    for (;;) {
+        if (j == RTA4A_NEXT) {
+            i += 1;
+            if (i == rts->rts_ntask) {
+                rts->schedulable[RTA4A_ID] = SCHED;
+                return SCHED;
+            }
+            tr += tasks[i]->c;
+            tasks[i]->loops_f[RTA4A_ID] += 1;
+            j = RTA4A_WHILE;
+        }
+
+        if (j == RTA4A_WHILE) {
+            if (tr <= min_i) {
+                tasks[i]->wcrt[RTA4A_ID] = tr;
+                j = RTA4A_NEXT;
+                continue;
+            }
+            min_i = tasks[i]->b_rta4a;
+            tasks[i]->loops_w[RTA4A_ID] += 1;
+            j = i - 1;
+        }
+
+        if (budget > 0 && used >= budget) {
+            k->i = i;
+            k->j = j;
+            k->tr = tr;
+            k->min_i = min_i;
+            return SUSPENDED;
+        }
+
+        tasks[i]->loops_f[RTA4A_ID] += 1;
+
+        if (tr > tasks[j]->b_rta4a) {
+            int a_dif = tr - tasks[j]->a_rta4a;
+            int a_t = U_CEIL( a_dif, tasks[j]->tmc );
+
+            tasks[i]->cc[RTA4A_ID] += 1;
+
+            tasks[j]->a_rta4a = a_t * tasks[j]->c;
+            tasks[j]->b_rta4a = a_t * tasks[j]->t;
+            tr = tasks[j]->a_rta4a + a_dif;
+
+            // verifica vencimiento
+            if (tr > tasks[i]->d) {
+                rts->schedulable[RTA4A_ID] = NON_SCHED;
+                return NON_SCHED;
+            }
+
+            if (budget_type == BUDGET_CC) {
+                used += 1;
+            }
+        }
+
+        if (min_i > tasks[j]->b_rta4a) {
+            min_i = tasks[j]->b_rta4a;
+        }
+
+        if (budget_type == BUDGET_ITER) {
+            used += 1;
+        }
+        if (budget_type == BUDGET_NS) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            used = (now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec);
+        }
+
+        j -= 1;
+        if (j < 0) {
+            j = RTA4A_WHILE;
+        }
+    }
+}
+
+/*
+ * RTA4A
+ * Evaluate the rts with rta4a_resume, resuming it until it ends. Each call
+ * uses the budget selected with --budget.
+ */
+int rta4a_wcrt(struct rts_t *rts)
+{
+    struct rta4_cont k;
+    rta4a_init(rts, &k);
+
+    int slices = 0;
+    int sched;
+    do {
+        sched = rta4a_resume(rts, &k, budget_type, budget);
+        slices += 1;
+    } while (sched == SUSPENDED);
+
+    #pragma omp atomic
+    rta4a_slices += slices;
+    #pragma omp critical (rta4a)
+    if (slices > rta4a_slices_max) {
+        rta4a_slices_max = slices;
+    }
+
+    return sched;
+}
+
+/*
+ * Compute the features of the rts used to select a method.
+ */
+void rts_features(struct rts_t *rts, struct features_t *f)
+{
+    struct task_t **tasks = rts->tasks;
+    int t_min = tasks[0]->t;
+    int t_max = tasks[0]->t;
+
+    f->n = rts->rts_ntask;
+    f->u = 0.0;
+    f->harmonic = 1;
+
+    int i;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        f->u += (double) tasks[i]->c / (double) tasks[i]->t;
+        if (tasks[i]->t < t_min) {
+            t_min = tasks[i]->t;
+        }
+        if (tasks[i]->t > t_max) {
+            t_max = tasks[i]->t;
+        }
+        if (i > 0 && tasks[i]->t % tasks[i - 1]->t != 0) {
+            f->harmonic = 0;
+        }
+    }
+
+    f->ratio = (double) t_max / (double) t_min;
+}
+
+/*
+ * Index of the first limit that is greater than or equal to x, or the last
+ * bucket if x is greater than all the limits.
+ */
+int auto_bucket(double x, const double *limits, int n)
+{
+    int i;
+    for (i = 0; i < n - 1; i++) {
+        if (x <= limits[i]) {
+            break;
+        }
+    }
+    return i;
+}
+
+/*
+ * Method predicted to be the fastest for the rts, looked up in auto_table.
+ */
+int auto_select(struct rts_t *rts)
+{
+    struct features_t f;
+    rts_features(rts, &f);
+
+    int n = auto_bucket(f.n, auto_n_limits, AUTO_N_BUCKETS);
+    int u = auto_bucket(f.u, auto_u_limits, AUTO_U_BUCKETS);
+    int r = auto_bucket(f.ratio, auto_ratio_limits, AUTO_RATIO_BUCKETS);
+
+    return auto_table[f.harmonic][n][u][r];
+}
+
+/*
+ * Clear the counters and the state of method m.
+ */
+void reset_method(struct rts_t *rts, int m)
+{
+    int i;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        struct task_t *task = rts->tasks[i];
+        task->cc[m] = 0;
+        task->loops_w[m] = 0;
+        task->loops_f[m] = 0;
+        task->wcrt[m] = 0;
+
+        if (m == RTA2_ID) {
+            task->a_rta2 = task->c;
+            task->b_rta2 = task->t;
+        }
+        if (m == RTA3_ID) {
+            task->a_rta3 = task->c;
+            task->b_rta3 = task->t;
+        }
+        if (m == RTA4_ID) {
+            task->a_rta4 = task->c;
+            task->b_rta4 = task->t;
+        }
+        if (m == RTA4A_ID) {
+            task->a_rta4a = task->c;
+            task->b_rta4a = task->t;
+        }
+        if (m == HET_ID) {
+            task->last_psi = 0;
+            task->last_workload = 0;
+        }
+        if (m == HETI_ID) {
+            task->heti_psi = 0;
+            task->heti_workload = 0;
+        }
+    }
+}
+
+/*
+ * AUTO
+ * Evaluate the rts with the method selected by auto_select. The counters and
+ * wcrt of the method are copied into the AUTO_ID slots. The features and the
+ * selection are part of the time measured for this method.
+ */
+int auto_wcrt(struct rts_t *rts)
+{
+    int m = auto_select(rts);
+    rts->auto_method = m;
+
+    // the method could be enabled too, so it is not traced nor attributed again
+    int trace_save = rts->trace;
+    int attribution_save = rts->attribution;
+    rts->trace = 0;
+    rts->attribution = 0;
+
+    reset_method(rts, m);
+    int sched = (*method_funcs[m])(rts);
+
+    rts->trace = trace_save;
+    rts->attribution = attribution_save;
+
+    int i;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        struct task_t *task = rts->tasks[i];
+        task->cc[AUTO_ID] = task->cc[m];
+        task->loops_w[AUTO_ID] = task->loops_w[m];
+        task->loops_f[AUTO_ID] = task->loops_f[m];
+        task->wcrt[AUTO_ID] = task->wcrt[m];
+    }
+
+    rts->schedulable[AUTO_ID] = sched;
+    return sched;
+}
+
+/*
+ * Add a record to the trace buffer of the thread, flushing it when full.
+ */
+void trace_add(int m, int i, int j, int old_tr, int new_tr, int iter)
+{
+    struct trace_rec *rec = &trace_buf[trace_len];
+    rec->rts_id = trace_rts;
+    rec->old_tr = old_tr;
+    rec->new_tr = new_tr;
+    rec->i = i;
+    rec->j = j;
+    rec->iter = iter;
+    rec->method = m;
+    rec->pad = 0;
+
+    trace_len += 1;
+    if (trace_len == TRACE_BUF_RECS) {
+        trace_flush();
+    }
+}
+
+/*
+ * Write the trace buffer of the thread into the trace file. Must be called by
+ * each thread that added records before it ends, that is, inside the parallel
+ * region that evaluated the rts.
+ */
+void trace_flush()
+{
+    #pragma omp critical (trace)
+    {
+        fwrite(trace_buf, sizeof(struct trace_rec), trace_len, trace_file);
+        trace_cnt += trace_len;
+    }
+    trace_len = 0;
+}
+
+/*
+ * Initial value for the wcrt of task i, according to seed_type. t is the wcrt
+ * of task i - 1. All the seeds are lower bounds of the wcrt of task i.
+ */
+int rta_seed(struct task_t **tasks, int i, int t)
+{
+    int seed = t + tasks[i]->c;
+
+    if (seed_type != SEED_SJODIN) {
+        // the bound is infinite if u_hp >= 1, and it is not cast above the deadline (it may overflow an int)
+        double bound = tasks[i]->u_hp < 1.0 ? ceil(tasks[i]->c / (1.0 - tasks[i]->u_hp) - 1e-9) : INFINITY;
+        int uf_seed = bound > tasks[i]->d ? tasks[i]->d + 1 : (int) bound;
+        if (seed_type == SEED_UF || uf_seed > seed) {
+            seed = uf_seed;
+        }
+    }
+
+    return seed;
+}
+
+/*
+ * RTA
+ * "Improved Response-Time Analysis Calculations"
+ * http://doi.ieeecomputersociety.org/10.1109/REAL.1998.739773
+ */
+int rta_wcrt(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
     
-    int min_i = tasks[0]->b_rta4;
-	
-	int i;
+    int w = 0;
+    int tr = 0;
+    int t = tasks[0]->c;
+    tasks[0]->wcrt[RTA_ID] = tasks[0]->c;
+
+    int i, j;
     for (i = 1; i < rts->rts_ntask; i++) {
-        tr += tasks[i]->c;
-        tasks[i]->loops_f[RTA4_ID] += 1;
-        
-        while (tr > min_i) { 
-            min_i = tasks[i]->b_rta4;
-                        
-            tasks[i]->loops_w[RTA4_ID] += 1;
-            
-            int j;
-            for (j = i - 1; j >= 0; j--) {
+        tr = rta_seed(tasks, i, t);
+        TRACE(RTA_ID, i, i, 0, tr);
+        tasks[i]->loops_f[RTA_ID] += 1;
+
+        do {
+            tasks[i]->loops_w[RTA_ID] += 1;
+            t = tr;
+            w = tasks[i]->c;
+
+            for (j = 0; j < i; j++) {
+                tasks[i]->loops_f[RTA_ID] += 1;
+                
+                int c_j = tasks[j]->c;
+                int t_j = tasks[j]->t;
+                int a = U_CEIL(tr, t_j);
+                tasks[i]->cc[RTA_ID] += 1;
+                
+                w = w + (a * c_j);
+                
+                if (w > tasks[i]->d) {
+                    rts->schedulable[RTA_ID] = NON_SCHED;
+                    return NON_SCHED;
+                }
+            }
             
-                tasks[i]->loops_f[RTA4_ID] += 1;
+            TRACE(RTA_ID, i, i, tr, w);
+            tr = w;
+        
+        } while (t != tr);
+
+        tasks[i]->wcrt[RTA_ID] = t;
+    }
+    
+    rts->schedulable[RTA_ID] = SCHED;
+    return SCHED;
+}
+
+/*
+ * RTA2
+ * "Reduced computational cost in the calculation of worst case response time for real time systems"
+ * http://sedici.unlp.edu.ar/handle/10915/9654
+ */
+int rta2_wcrt(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
+
+    int tr = 0;
+    int t = tasks[0]->c;
+    tasks[0]->wcrt[RTA2_ID] = tasks[0]->c;
+
+    int i, j;
+    for (i = 1; i < rts->rts_ntask; i++) {
+        tr = t + tasks[i]->c;
+        TRACE(RTA2_ID, i, i, 0, tr);
+        tasks[i]->loops_f[RTA2_ID] += 1;
+
+        // raise the interference up to the selected seed
+        int seed = rta_seed(tasks, i, t);
+        if (seed > tr) {
+            for (j = 0; j < i; j++) {
+                tasks[i]->loops_f[RTA2_ID] += 1;
+
+                int a = U_CEIL(seed, tasks[j]->t);
+                tasks[i]->cc[RTA2_ID] += 1;
+                ATTR_CC(RTA2_ID, i, j);
+                a = a * tasks[j]->c;
+
+                if (a > tasks[j]->a_rta2) {
+                    ATTR_EXP(RTA2_ID, i, j);
+                    TRACE(RTA2_ID, i, j, tr, tr + a - tasks[j]->a_rta2);
+                    tr = tr + a - tasks[j]->a_rta2;
+                    tasks[j]->a_rta2 = a;
+                }
+            }
+
+            if (tr > tasks[i]->d) {
+                rts->schedulable[RTA2_ID] = NON_SCHED;
+                return NON_SCHED;
+            }
+        }
+
+        do {
+            tasks[i]->loops_w[RTA2_ID] += 1;
+            t = tr;
+
+            for (j = 0; j < i; j++) {
+                tasks[i]->loops_f[RTA2_ID] += 1;
+                
+                int a = U_CEIL(tr, tasks[j]->t);
+                tasks[i]->cc[RTA2_ID] += 1;
+                ATTR_CC(RTA2_ID, i, j);
+                a = a * tasks[j]->c;
+                
+                if (a > tasks[j]->a_rta2) {
+                    ATTR_EXP(RTA2_ID, i, j);
+                    TRACE(RTA2_ID, i, j, tr, tr + a - tasks[j]->a_rta2);
+                    tr = tr + a - tasks[j]->a_rta2;
+                    tasks[j]->a_rta2 = a;
+                    
+                    if (tr > tasks[i]->d) {
+                        rts->schedulable[RTA2_ID] = NON_SCHED;
+                        return NON_SCHED;
+                    }
+                }
+            }
+        } while (t != tr);
+     
+        tasks[i]->wcrt[RTA2_ID] = t;
+    }
+    
+    rts->schedulable[RTA2_ID] = SCHED;
+    return SCHED;
+}
+
+/*
+ * RTA3
+ * "Computational Cost Reduction for Real-Time Schedulability Tests Algorithms"
+ * http://ieeexplore.ieee.org/document/7404899/
+ */
+int rta3_wcrt(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
+
+    int tr = 0;
+    int t = tasks[0]->c;
+    tasks[0]->wcrt[RTA3_ID] = tasks[0]->c;
+
+    int i, j;
+    for (i = 1; i < rts->rts_ntask; i++) {
+        tr = t + tasks[i]->c;
+        TRACE(RTA3_ID, i, i, 0, tr);
+        tasks[i]->loops_f[RTA3_ID] += 1;
+
+        // raise the interference up to the selected seed
+        int seed = rta_seed(tasks, i, t);
+        if (seed > tr) {
+            for (j = i - 1; j >= 0; j--) {
+                tasks[i]->loops_f[RTA3_ID] += 1;
+
+                if (seed > tasks[j]->b_rta3) {
+                    int a_t = U_CEIL(seed, tasks[j]->t);
+                    tasks[i]->cc[RTA3_ID] += 1;
+                    ATTR_CC(RTA3_ID, i, j);
+                    ATTR_EXP(RTA3_ID, i, j);
+
+                    int a = a_t * tasks[j]->c;
+                    TRACE(RTA3_ID, i, j, tr, tr + a - tasks[j]->a_rta3);
+                    tr = tr + a - tasks[j]->a_rta3;
+
+                    tasks[j]->a_rta3 = a;
+                    tasks[j]->b_rta3 = a_t * tasks[j]->t;
+                }
+            }
+
+            if (tr > tasks[i]->d) {
+                rts->schedulable[RTA3_ID] = NON_SCHED;
+                return NON_SCHED;
+            }
+        }
+
+        do {
+            tasks[i]->loops_w[RTA3_ID] += 1;
+            t = tr;
+            
+            for (j = i - 1; j >= 0; j--) {
+                tasks[i]->loops_f[RTA3_ID] += 1;
+            
+                if (tr > tasks[j]->b_rta3) {
+                    int a_t = U_CEIL(tr, tasks[j]->t);
+                    tasks[i]->cc[RTA3_ID] += 1;
+                    ATTR_CC(RTA3_ID, i, j);
+                    ATTR_EXP(RTA3_ID, i, j);
+
+                    int a = a_t * tasks[j]->c;
+                    TRACE(RTA3_ID, i, j, tr, tr + a - tasks[j]->a_rta3);
+                    tr = tr + a - tasks[j]->a_rta3;
+
+                    tasks[j]->a_rta3 = a;
+                    tasks[j]->b_rta3 = a_t * tasks[j]->t;
+                    
+                    // verifica vencimiento
+                    if (tr > tasks[i]->d) {
+                        rts->schedulable[RTA3_ID] = NON_SCHED;
+                        return NON_SCHED;
+                    }
+                }
+            }            
+        } while (t != tr);
+
+        tasks[i]->wcrt[RTA3_ID] = t;
+    }
+    
+    rts->schedulable[RTA3_ID] = SCHED;
+    return SCHED;
+}
+
+/*
+ * RTA4
+ */
+int rta4_wcrt(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
+
+    int tr = tasks[0]->c;
+    tasks[0]->wcrt[RTA4_ID] = tasks[0]->c;
+    
+    int min_i = tasks[0]->b_rta4;
+	
+	int i;
+    for (i = 1; i < rts->rts_ntask; i++) {
+        tr += tasks[i]->c;
+        TRACE(RTA4_ID, i, i, 0, tr);
+        tasks[i]->loops_f[RTA4_ID] += 1;
+
+        // raise the interference up to the selected seed
+        int seed = rta_seed(tasks, i, tr - tasks[i]->c);
+        if (seed > tr) {
+            int j;
+            for (j = i - 1; j >= 0; j--) {
+                tasks[i]->loops_f[RTA4_ID] += 1;
+
+                if (seed > tasks[j]->b_rta4) {
+                    int a_t = U_CEIL(seed, tasks[j]->t);
+                    tasks[i]->cc[RTA4_ID] += 1;
+                    ATTR_CC(RTA4_ID, i, j);
+                    ATTR_EXP(RTA4_ID, i, j);
+
+                    int a = a_t * tasks[j]->c;
+                    TRACE(RTA4_ID, i, j, tr, tr + a - tasks[j]->a_rta4);
+                    tr = tr + a - tasks[j]->a_rta4;
+
+                    tasks[j]->a_rta4 = a;
+                    tasks[j]->b_rta4 = a_t * tasks[j]->t;
+                }
+            }
+
+            if (tr > tasks[i]->d) {
+                rts->schedulable[RTA4_ID] = NON_SCHED;
+                return NON_SCHED;
+            }
+
+            // min_i is recomputed by the next while loop
+            min_i = 0;
+        }
+        
+        while (tr > min_i) { 
+            min_i = tasks[i]->b_rta4;
+                        
+            tasks[i]->loops_w[RTA4_ID] += 1;
+            
+            int j;
+            for (j = i - 1; j >= 0; j--) {
+            
+                tasks[i]->loops_f[RTA4_ID] += 1;
+
+                if (tr > tasks[j]->b_rta4) {
+                    int a_dif = tr - tasks[j]->a_rta4;
+                    int a_t = U_CEIL( a_dif, tasks[j]->tmc );
+                    
+                    tasks[i]->cc[RTA4_ID] += 1;
+                    ATTR_CC(RTA4_ID, i, j);
+                    ATTR_EXP(RTA4_ID, i, j);
+
+                    tasks[j]->a_rta4 = a_t * tasks[j]->c;
+                    tasks[j]->b_rta4 = a_t * tasks[j]->t;
+                    TRACE(RTA4_ID, i, j, tr, tasks[j]->a_rta4 + a_dif);
+                    tr = tasks[j]->a_rta4 + a_dif;
+                    
+                    // verifica vencimiento
+                    if (tr > tasks[i]->d) {
+                        rts->schedulable[RTA4_ID] = NON_SCHED;
+                        return NON_SCHED;
+                    }
+                }
+
+                if (min_i > tasks[j]->b_rta4) {
+                    min_i = tasks[j]->b_rta4;
+                }
+            }
+        }
+
+        tasks[i]->wcrt[RTA4_ID] = tr;
+    }
+	
+    rts->schedulable[RTA4_ID] = SCHED;
+    return SCHED;
+}
+
+/*
+ * Parametric RTA
+ * Computes the wcrt of the tasks k..n-1 as a piecewise-linear function of the
+ * wcet of task k, for C_k in [lo, hi]. While the number of jobs of every
+ * interferer in the busy window does not change, the fixpoint is
+ * w = alpha + beta * C_k. A new segment starts when w crosses the end of the
+ * window of some interferer j (n_j * T_j), or the deadline of task i. Returns
+ * the number of ceil operations performed.
+ */
+int rta_param(struct rts_t *rts, int k, int lo, int hi, FILE *f)
+{
+    struct task_t **tasks = rts->tasks;
+    int *b = malloc(sizeof(int) * rts->rts_ntask);   // window end of each interferer
+    int cc = 0;
+
+    fprintf(f, "Param: rts %d, task %d, C in [%d, %d]\n", rts->rts_id, k + 1, lo, hi);
+    fprintf(f, "%6s%10s%10s%10s%10s\n", "task", "c_from", "c_to", "wcrt", "slope");
+
+    int i, j;
+    for (i = k; i < rts->rts_ntask; i++) {
+        int c_i = (i == k) ? lo : tasks[i]->c;
+        int w = c_i;
+        for (j = 0; j < i; j++) {
+            w += (j == k) ? lo : tasks[j]->c;
+        }
+
+        int c = lo;
+        while (c <= hi) {
+            int t;
+            c_i = (i == k) ? c : tasks[i]->c;
+
+            // fixpoint for C_k = c, starting from the previous segment end
+            do {
+                t = w;
+                w = c_i;
+                for (j = 0; j < i; j++) {
+                    w += U_CEIL(t, tasks[j]->t) * ((j == k) ? c : tasks[j]->c);
+                    cc += 1;
+                }
+            } while (t != w && w <= tasks[i]->d);
+
+            if (w > tasks[i]->d) {
+                fprintf(f, "%6d%10d%10s%10s%10s\n", i + 1, c, "-", "unsched", "-");
+                break;
+            }
+
+            // coefficients of the current segment
+            int alpha = (i == k) ? 0 : c_i;
+            int beta = (i == k) ? 1 : 0;
+            for (j = 0; j < i; j++) {
+                int n_j = U_CEIL(w, tasks[j]->t);
+                cc += 1;
+                b[j] = n_j * tasks[j]->t;
+                if (j == k) {
+                    beta += n_j;
+                } else {
+                    alpha += n_j * tasks[j]->c;
+                }
+            }
+
+            // first C_k value beyond the segment
+            int c_next = hi + 1;
+            int nb = U_FLOOR((tasks[i]->d - alpha), beta) + 1;
+            if (nb < c_next) {
+                c_next = nb;
+            }
+            for (j = 0; j < i; j++) {
+                nb = U_FLOOR((b[j] - alpha), beta) + 1;
+                if (nb < c_next) {
+                    c_next = nb;
+                }
+            }
+            cc += i + 1;
+
+            fprintf(f, "%6d%10d%10d%10d%10d\n", i + 1, c, c_next - 1, w, beta);
+
+            w = alpha + beta * (c_next - 1);
+            c = c_next;
+        }
+    }
+
+    fprintf(f, "Param cc: %d\n", cc);
+
+    free(b);
+    return cc;
+}
+
+/*
+ * Single task RTA4 test, used as the oracle of the OPA. Evaluates task x with
+ * the nhp tasks indexed in hp as its higher priority tasks. The arrays a and b
+ * hold the interference state of each higher priority task. They are rebuilt
+ * on each call: the activations found with a set of higher priority tasks are
+ * not a lower bound with a subset of them, as the busy period can be shorter.
+ */
+int rta4_task_test(struct task_t **tasks, int *hp, int nhp, int x, int *a, int *b, int *cc)
+{
+    int tr = tasks[x]->c;
+    int min_b = tasks[x]->t;
+
+    int k;
+    for (k = 0; k < nhp; k++) {
+        a[k] = tasks[hp[k]]->c;
+        b[k] = tasks[hp[k]]->t;
+        tr += a[k];
+        if (min_b > b[k]) {
+            min_b = b[k];
+        }
+    }
+
+    if (tr > tasks[x]->d) {
+        return NON_SCHED;
+    }
+
+    while (tr > min_b) {
+        min_b = tasks[x]->t;
+
+        for (k = nhp - 1; k >= 0; k--) {
+            struct task_t *task = tasks[hp[k]];
+
+            if (tr > b[k]) {
+                int a_dif = tr - a[k];
+                int a_t = U_CEIL(a_dif, task->tmc);
+                *cc += 1;
+
+                a[k] = a_t * task->c;
+                b[k] = a_t * task->t;
+                tr = a[k] + a_dif;
+
+                if (tr > tasks[x]->d) {
+                    return NON_SCHED;
+                }
+            }
+
+            if (min_b > b[k]) {
+                min_b = b[k];
+            }
+        }
+    }
+
+    return SCHED;
+}
+
+/*
+ * OPA
+ * "Optimal Priority Assignment and Feasibility of Static Priority Tasks With Arbitrary Start Times"
+ * N. C. Audsley, University of York, 1991.
+ * --
+ * Assigns priorities from the lowest level upwards. At each level the candidates
+ * are tested in parallel against the remaining unassigned tasks. A task that
+ * passes the test at one level also passes it at all the higher levels (it has
+ * less interference), so its result is cached and never evaluated again. The
+ * task indexes, from the highest to the lowest priority, are stored in order.
+ */
+int opa_assign(struct rts_t *rts, int *order, long *cc)
+{
+    struct task_t **tasks = rts->tasks;
+    int n = rts->rts_ntask;
+
+    int *unassigned = malloc(sizeof(int) * n);
+    int *passed = calloc(n, sizeof(int));
+
+    int k;
+    for (k = 0; k < n; k++) {
+        unassigned[k] = k;
+    }
+
+    int m = n;
+    int level;
+    for (level = n - 1; level >= 0; level--) {
+        int level_cc = 0;
+
+        #pragma omp parallel
+        {
+            int *hp = malloc(sizeof(int) * n);
+            int *a = malloc(sizeof(int) * n);
+            int *b = malloc(sizeof(int) * n);
+
+            int c;
+            #pragma omp for schedule(dynamic) reduction(+:level_cc)
+            for (c = 0; c < m; c++) {
+                int x = unassigned[c];
+                if (passed[x] == SCHED) {
+                    continue;
+                }
+
+                // the other unassigned tasks have higher priority than x
+                int nhp = 0;
+                int l;
+                for (l = 0; l < m; l++) {
+                    if (l != c) {
+                        hp[nhp++] = unassigned[l];
+                    }
+                }
+
+                int test_cc = 0;
+                passed[x] = rta4_task_test(tasks, hp, nhp, x, a, b, &test_cc);
+                level_cc += test_cc;
+            }
+
+            free(hp);
+            free(a);
+            free(b);
+        }
+
+        *cc += level_cc;
+
+        // prefer the candidate with the lowest original priority
+        for (k = m - 1; k >= 0; k--) {
+            if (passed[unassigned[k]] == SCHED) {
+                break;
+            }
+        }
+
+        if (k < 0) {
+            free(unassigned);
+            free(passed);
+            return NON_SCHED;
+        }
+
+        order[level] = unassigned[k];
+        for (; k < m - 1; k++) {
+            unassigned[k] = unassigned[k + 1];
+        }
+        m = m - 1;
+    }
+
+    free(unassigned);
+    free(passed);
+    return SCHED;
+}
+
+/*
+ * Detect the harmonic structure of the rts. Only rts in RM order are flagged as
+ * harmonic, as the closed form requires the higher priority tasks of each task
+ * sorted by period. The chains are built greedily, adding each period to the
+ * first chain whose last period divides it. They are only reported (chains
+ * mean): a partition in chains bounds the wcrt but does not give it exactly,
+ * so the rts with more than one chain are evaluated by the methods.
+ */
+void harmonic_rts(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
+    int *last = malloc(sizeof(int) * rts->rts_ntask);   // last period of each chain
+
+    rts->harmonic = 1;
+    rts->chains = 0;
+
+    int i, k;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        if (i > 0 && tasks[i]->t % tasks[i - 1]->t != 0) {
+            rts->harmonic = 0;
+        }
+
+        for (k = 0; k < rts->chains; k++) {
+            if (tasks[i]->t % last[k] == 0) {
+                break;
+            }
+        }
+        if (k == rts->chains) {
+            rts->chains += 1;
+        }
+        last[k] = tasks[i]->t;
+    }
+
+    free(last);
+}
+
+/*
+ * Closed form wcrt for harmonic rts in RM order. As every period divides the
+ * larger ones, all the tasks 0..k are released together at each multiple of
+ * T_k, and leave S_k = T_k - sum_j (T_k / T_j) C_j free units in each period.
+ * A workload X at a lower priority level completes after m = ceil(X / S_k) - 1
+ * full periods, plus the response time of the remaining work and one job of
+ * task k under the tasks 0..k-1. Each task requires one division per higher
+ * priority task.
+ */
+int harmonic_wcrt(struct rts_t *rts, long *cc)
+{
+    struct task_t **tasks = rts->tasks;
+    int *spare = malloc(sizeof(int) * rts->rts_ntask);
+
+    int i, k, m;
+    int demand = 0;     // sum_j (T_k / T_j) C_j
+    for (k = 0; k < rts->rts_ntask; k++) {
+        if (k > 0) {
+            demand = demand * (tasks[k]->t / tasks[k - 1]->t);
+        }
+        demand += tasks[k]->c;
+        spare[k] = tasks[k]->t - demand;
+    }
+
+    for (i = 0; i < rts->rts_ntask; i++) {
+        int x = tasks[i]->c;
+        int r = 0;
+
+        for (k = i - 1; k >= 0; k--) {
+            if (spare[k] <= 0) {
+                free(spare);
+                return NON_SCHED;
+            }
+            int p = U_CEIL(x, spare[k]) - 1;
+            *cc += 1;
+            r += p * tasks[k]->t;
+            x = x - p * spare[k] + tasks[k]->c;
+        }
+        r += x;
+
+        if (r > tasks[i]->d) {
+            free(spare);
+            return NON_SCHED;
+        }
+
+        for (m = 0; m < NUM_SCHED_METHODS; m++) {
+            tasks[i]->wcrt[m] = r;
+        }
+    }
+
+    free(spare);
+    return SCHED;
+}
+
+/*
+ * Returns a copy of the rts where each run of consecutive tasks with the same
+ * period and deadline is replaced by a virtual task with the sum of their
+ * wcet. The virtual task has the id of the last task of the run, and its wcrt
+ * is the wcrt of that task. Returns rts itself if there is nothing to merge.
+ */
+struct rts_t *merge_rts(struct rts_t *rts)
+{
+    struct task_t **tasks = rts->tasks;
+    int n = 0;
+
+    int i;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        if (i == 0 || tasks[i]->t != tasks[i - 1]->t || tasks[i]->d != tasks[i - 1]->d) {
+            n += 1;
+        }
+    }
+
+    if (n == rts->rts_ntask) {
+        return rts;
+    }
+
+    struct rts_t *merged = malloc(sizeof(struct rts_t));
+    merged->rts_id = rts->rts_id;
+    merged->rts_uf = rts->rts_uf;
+    merged->rts_ntask = 0;
+    merged->auto_method = 0;
+    merged->trace = rts->trace;
+    merged->attribution = rts->attribution;
+    merged->schedulable = malloc(sizeof(int) * NUM_SCHED_METHODS);
+    merged->tasks = malloc(sizeof(struct task_t*) * n);
+
+    for (i = 0; i < rts->rts_ntask; i++) {
+        struct task_t *v = (merged->rts_ntask > 0) ? merged->tasks[merged->rts_ntask - 1] : NULL;
+
+        if (v != NULL && v->t == tasks[i]->t && v->d == tasks[i]->d && v->c + tasks[i]->c < v->t) {
+            v->c += tasks[i]->c;
+            v->tmc = v->t - v->c;
+            v->id = tasks[i]->id;
+        } else {
+            v = malloc(sizeof(struct task_t));
+            v->id = tasks[i]->id;
+            v->c = tasks[i]->c;
+            v->t = tasks[i]->t;
+            v->d = tasks[i]->d;
+            v->tmc = tasks[i]->tmc;
+            merged->tasks[merged->rts_ntask] = v;
+            merged->rts_ntask += 1;
+        }
+    }
+
+    reset_rts(merged);
+
+    return merged;
+}
+
+/*
+ * Copy the results of the merged rts back into rts, and release it. The last
+ * task of a run gets the wcrt of the virtual task. The wcrt of the other tasks
+ * of the run is the fixed point of the sum of the wcet of the run up to the
+ * task and the interference of the tasks before the run, which converges below
+ * the wcrt of the virtual task. The tasks of a run that a method did not find
+ * schedulable get the wcrt of the virtual task.
+ */
+void unmerge_rts(struct rts_t *rts, struct rts_t *merged)
+{
+    struct task_t **tasks = rts->tasks;
+
+    int i, j, m;
+    int v = 0;
+    int first = 0;      // first task of the run
+    int run_c = 0;      // wcet of the run up to the task
+    for (i = 0; i < rts->rts_ntask; i++) {
+        struct task_t *vt = merged->tasks[v];
+        run_c += tasks[i]->c;
+
+        int t = 0;
+        if (tasks[i]->id != vt->id) {
+            int w = run_c;
+            for (j = 0; j < first; j++) {
+                w += tasks[j]->c;
+            }
+            do {
+                t = w;
+                w = run_c;
+                for (j = 0; j < first; j++) {
+                    w += (int) ceil((double) t / (double) tasks[j]->t) * tasks[j]->c;
+                }
+            } while (w != t && w <= vt->d);
+        }
+
+        for (m = 0; m < NUM_SCHED_METHODS; m++) {
+            if (t > 0 && vt->wcrt[m] > 0 && vt->wcrt[m] <= vt->d) {
+                tasks[i]->wcrt[m] = t;
+            } else {
+                tasks[i]->wcrt[m] = vt->wcrt[m];
+            }
+        }
+
+        if (tasks[i]->id == vt->id) {
+            v += 1;
+            first = i + 1;
+            run_c = 0;
+        }
+    }
+
+    for (m = 0; m < NUM_SCHED_METHODS; m++) {
+        rts->schedulable[m] = merged->schedulable[m];
+    }
+
+    for (i = 0; i < merged->rts_ntask; i++) {
+        free(merged->tasks[i]);
+    }
+    free(merged->tasks);
+    free(merged->schedulable);
+    free(merged);
+}
+
+void reset_rts(struct rts_t *rts)
+{
+    reset_tasks(rts);
+
+    if (harmonic == 1) {
+        harmonic_rts(rts);
+    }
+
+    if (attribution == 1) {
+        attr_reset(rts->rts_ntask);
+    }
+}
+
+/*
+ * Clear the state and the results of the methods in the tasks of the rts.
+ * Unlike reset_rts, it does not touch the global counters, so it can be
+ * called from several threads at the same time.
+ */
+void reset_tasks(struct rts_t *rts)
+{
+    double u_hp = 0.0;
+
+    int i, j;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        struct task_t *task = rts->tasks[i];
+
+        task->u_hp = u_hp;
+        u_hp += (double) task->c / (double) task->t;
+
+        task->a_rta2 = task->c;
+        task->b_rta2 = task->t;
+        task->a_rta3 = task->c;
+        task->b_rta3 = task->t;
+        task->a_rta4 = task->c;
+        task->b_rta4 = task->t;
+        task->a_rta4a = task->c;
+        task->b_rta4a = task->t;
+        task->last_psi = 0;
+        task->last_workload = 0;
+        task->heti_psi = 0;
+        task->heti_workload = 0;
+                       
+        for (j = 0; j < NUM_SCHED_METHODS; j++) {
+            task->cc[j] = 0;
+            task->loops_w[j] = 0;
+            task->loops_f[j] = 0;
+            task->wcrt[j] = 0;
+        }
+    }
+}
+
+/*
+ * Make room in the attribution counters for a rts with n tasks, and clear the
+ * counters of the (i, j) pairs.
+ */
+void attr_reset(int n)
+{
+    int m;
+    if (n > attr_n) {
+        for (m = 0; m < NUM_SCHED_METHODS; m++) {
+            free(attr_cc[m]);
+            free(attr_exp[m]);
+            attr_cc[m] = malloc(sizeof(int) * n * n);
+            attr_exp[m] = malloc(sizeof(int) * n * n);
+            level_cc[m] = realloc(level_cc[m], sizeof(long) * n);
+            level_exp[m] = realloc(level_exp[m], sizeof(long) * n);
+            memset(level_cc[m] + attr_n, 0, sizeof(long) * (n - attr_n));
+            memset(level_exp[m] + attr_n, 0, sizeof(long) * (n - attr_n));
+        }
+        attr_n = n;
+    }
+
+    for (m = 0; m < NUM_SCHED_METHODS; m++) {
+        memset(attr_cc[m], 0, sizeof(int) * n * attr_n);
+        memset(attr_exp[m], 0, sizeof(int) * n * attr_n);
+    }
+}
+
+/*
+ * Write the attribution counters of the rts into attr_file. For each method,
+ * one "pair" line for each (i, j) pair with a ceil operation or an expiry, and
+ * the ATTR_HOT tasks that caused most ceil operations as "hot" lines. The
+ * priority levels i and j start at 1.
+ */
+void attr_report(struct rts_t *rts, struct method_t *methods)
+{
+    int attr_ids[] = {RTA2_ID, RTA3_ID, RTA4_ID};
+    int n = rts->rts_ntask;
+    long *col_cc = malloc(sizeof(long) * n);
+    long *col_exp = malloc(sizeof(long) * n);
+
+    int i, j, k, r;
+    for (k = 0; k < 3; k++) {
+        int m = attr_ids[k];
+        if (methods[m].enabled == 0) {
+            continue;
+        }
+
+        long total = 0;
+        for (j = 0; j < n; j++) {
+            col_cc[j] = 0;
+            col_exp[j] = 0;
+        }
+
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < i; j++) {
+                int cc = attr_cc[m][i * attr_n + j];
+                int exp = attr_exp[m][i * attr_n + j];
+                if (cc > 0 || exp > 0) {
+                    fprintf(attr_file, "pair,%d,%s,%d,%d,%d,%d\n", rts->rts_id, methods[m].method_name, i + 1, j + 1, cc, exp);
+                }
+                col_cc[j] += cc;
+                col_exp[j] += exp;
+            }
+        }
+
+        for (j = 0; j < n; j++) {
+            level_cc[m][j] += col_cc[j];
+            level_exp[m][j] += col_exp[j];
+            total += col_cc[j];
+        }
+
+        // ranking, the selected task is removed by setting its count to -1
+        for (r = 0; r < ATTR_HOT && r < n; r++) {
+            int hot = 0;
+            for (j = 1; j < n; j++) {
+                if (col_cc[j] > col_cc[hot]) {
+                    hot = j;
+                }
+            }
+            if (col_cc[hot] <= 0) {
+                break;
+            }
+            if (r == 0 && total > 0) {
+                hot_share[m] += (double) col_cc[hot] / (double) total;
+            }
+            fprintf(attr_file, "hot,%d,%s,%d,%d,%ld,%ld\n", rts->rts_id, methods[m].method_name, r + 1, hot + 1, col_cc[hot], col_exp[hot]);
+            col_cc[hot] = -1;
+        }
+    }
+
+    free(col_cc);
+    free(col_exp);
+}
+
+/*
+ * Screen the RTS with sufficient tests, from the cheapest to the most
+ * expensive one. Returns the tier that settled the RTS, and its result in
+ * sched, or SCREEN_EXACT if none of them could.
+ * --
+ * The Liu & Layland and hyperbolic bounds are applied to the densities C/D,
+ * so they require the tasks in DM order. The response time upper bound is
+ * valid for any priority order with D <= T:
+ * "A Response-Time Bound in Fixed-Priority Scheduling with Arbitrary Deadlines"
+ * http://ieeexplore.ieee.org/document/4752824/
+ */
+int screen_rts(struct rts_t *rts, int *sched)
+{
+    struct task_t **tasks = rts->tasks;
+    int n = rts->rts_ntask;
+
+    double uf = 0.0;
+    double density = 0.0;
+    double hb = 1.0;
+    int dm_order = 1;
+
+    int i;
+    for (i = 0; i < n; i++) {
+        uf += (double) tasks[i]->c / (double) tasks[i]->t;
+        density += (double) tasks[i]->c / (double) tasks[i]->d;
+        hb *= (double) tasks[i]->c / (double) tasks[i]->d + 1.0;
+        if (i > 0 && tasks[i]->d < tasks[i - 1]->d) {
+            dm_order = 0;
+        }
+    }
+
+    if (uf > 1.0 + 1e-9) {
+        *sched = NON_SCHED;
+        return SCREEN_UF;
+    }
+
+    *sched = SCHED;
+
+    if (dm_order == 1) {
+        if (density <= n * (pow(2.0, 1.0 / n) - 1.0) - 1e-9) {
+            return SCREEN_LL;
+        }
+        if (hb <= 2.0 - 1e-9) {
+            return SCREEN_HB;
+        }
+    }
+
+    double sum_c = 0.0;     // sum of C_j * (1 - U_j) of the higher priority tasks
+    double sum_u = 0.0;     // utilization of the higher priority tasks
+    for (i = 0; i < n; i++) {
+        double r_ub = (tasks[i]->c + sum_c) / (1.0 - sum_u);
+        if (sum_u >= 1.0 || r_ub > tasks[i]->d - 1e-9) {
+            return SCREEN_EXACT;
+        }
+        double u = (double) tasks[i]->c / (double) tasks[i]->t;
+        sum_c += tasks[i]->c * (1.0 - u);
+        sum_u += u;
+    }
+
+    return SCREEN_RTB;
+}
+
+/*
+ * Fail-fast test. Bounds the wcrt of every task, and applies the exact test
+ * only to the task most likely to miss its deadline: the one with the largest
+ * ratio between the lower bound of its wcrt and its deadline, among the tasks
+ * whose upper bound exceeds the deadline. Returns NON_SCHED if some task misses
+ * its deadline, or SCHED if the rts must be evaluated in the normal order.
+ */
+int fail_fast_rts(struct rts_t *rts, int *cc)
+{
+    struct task_t **tasks = rts->tasks;
+    int n = rts->rts_ntask;
+
+    double sum_c = 0.0;     // sum of C_j * (1 - U_j) of the higher priority tasks
+    double sum_u = 0.0;     // utilization of the higher priority tasks
+    int sum_wcet = 0;       // wcet of the task and of the higher priority tasks
+    double max_ratio = 0.0;
+    int x = -1;
+
+    int i;
+    for (i = 0; i < n; i++) {
+        sum_wcet += tasks[i]->c;
+
+        int lb = sum_wcet;
+        if (sum_u < 1.0) {
+            // a bound above the deadline is not cast, it may overflow an int
+            double uf_lb = ceil(tasks[i]->c / (1.0 - sum_u) - 1e-9);
+            if (uf_lb > tasks[i]->d) {
+                return NON_SCHED;
+            }
+            if ((int) uf_lb > lb) {
+                lb = (int) uf_lb;
+            }
+        }
+
+        if (lb > tasks[i]->d) {
+            return NON_SCHED;
+        }
+
+        if (sum_u >= 1.0 || (tasks[i]->c + sum_c) / (1.0 - sum_u) > tasks[i]->d - 1e-9) {
+            double ratio = (double) lb / (double) tasks[i]->d;
+            if (ratio > max_ratio) {
+                max_ratio = ratio;
+                x = i;
+            }
+        }
+
+        double u = (double) tasks[i]->c / (double) tasks[i]->t;
+        sum_c += tasks[i]->c * (1.0 - u);
+        sum_u += u;
+    }
+
+    if (x < 0) {
+        return SCHED;
+    }
+
+    int *hp = malloc(sizeof(int) * n);
+    int *a = malloc(sizeof(int) * n);
+    int *b = malloc(sizeof(int) * n);
+    for (i = 0; i < x; i++) {
+        hp[i] = i;
+    }
+
+    int sched = rta4_task_test(tasks, hp, x, x, a, b, cc);
+
+    free(hp);
+    free(a);
+    free(b);
+
+    return sched;
+}
+
+/*
+ * Stack painting. With probe == 0, fill with STACK_PATTERN the STACK_PAINT_SIZE
+ * bytes of the stack below the caller, but only from the deepest word that was
+ * overwritten since the last call, as the words below it keep the pattern. With
+ * probe == 1, return the number of those bytes overwritten since then. Both
+ * calls must be made from the same function, so that buf is at the same address.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+__attribute__((noinline)) long stack_paint(int probe)
+{
+    volatile uint64_t buf[STACK_PAINT_SIZE / 8];
+    uint64_t pattern = STACK_PATTERN * 0x0101010101010101ULL;
+
+    // the stack grows down, so buf[0] is the deepest word
+    long i = 0;
+    while (i < STACK_PAINT_SIZE / 8 && buf[i] == pattern) {
+        i++;
+    }
+
+    if (probe == 0) {
+        for (; i < STACK_PAINT_SIZE / 8; i++) {
+            buf[i] = pattern;
+        }
+        return 0;
+    }
+
+    long used = STACK_PAINT_SIZE - i * 8;
+    if (i < STACK_PAINT_SIZE / 8) {
+        // the deepest bytes of the word that keep the pattern
+        volatile unsigned char *b = (volatile unsigned char *) &buf[i];
+        int k;
+        for (k = 0; k < 8 && b[k] == STACK_PATTERN; k++) {
+            used -= 1;
+        }
+    }
+    return used;
+}
+#pragma GCC diagnostic pop
+
+/*
+ * Bytes of heap in use.
+ */
+long heap_in_use()
+{
+    struct mallinfo2 mi = mallinfo2();
+    return (long) (mi.uordblks + mi.hblkhd);
+}
+
+/*
+ * Evaluate the rts with the methods in the methods array, and store the totals
+ * in the position idx of the results.
+ */
+void evaluate_rts(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int i, j;
+
+    reset_rts(rts);
+    trace_rts = rts->rts_id;
+    rts->trace = trace;
+    rts->attribution = attribution;
+
+    // the exact methods are not used if a sufficient test settles the rts
+    if (screen == 1) {
+        int sched;
+        int tier = screen_rts(rts, &sched);
+        screen_cnt[tier] += 1;
+
+        if (tier != SCREEN_EXACT) {
+            for (i = 0; i < NUM_SCHED_METHODS; i++) {
+                rts->schedulable[methods[i].method_id] = sched;
+            }
+            settled[idx] = 1;
+            settled_cnt += 1;
+            return;
+        }
+    }
+
+    // the methods are not used if the fail-fast test finds a deadline miss,
+    // unless they are evaluated to verify its result
+    int fail_fast_sched = SCHED;
+    if (fail_fast == 1) {
+        int cc = 0;
+        fail_fast_sched = fail_fast_rts(rts, &cc);
+        fail_fast_cc += cc;
+        if (fail_fast_sched == NON_SCHED) {
+            fail_fast_cnt += 1;
+
+            if (fail_fast_verify == 0) {
+                for (i = 0; i < NUM_SCHED_METHODS; i++) {
+                    rts->schedulable[methods[i].method_id] = NON_SCHED;
+                }
+                settled[idx] = 1;
+                settled_cnt += 1;
+                return;
+            }
+        }
+    }
+
+    // harmonic rts use the closed form
+    struct rts_t *eval_rts = rts;
+    if (harmonic == 1) {
+        chains_sum += rts->chains;
+
+        if (rts->harmonic == 1) {
+            int sched = harmonic_wcrt(rts, &harmonic_cc);
+            harmonic_cnt += 1;
+            for (i = 0; i < NUM_SCHED_METHODS; i++) {
+                rts->schedulable[methods[i].method_id] = sched;
+            }
+            settled[idx] = 1;
+            settled_cnt += 1;
+            return;
+        }
+    }
+
+    // equal period tasks are merged
+    if (merge == 1) {
+        eval_rts = merge_rts(rts);
+        if (eval_rts != rts) {
+            merged_cnt += 1;
+            merged_tasks += rts->rts_ntask - eval_rts->rts_ntask;
+        }
+    }
+
+    // run first the methods that use the seed with the default one, to count the iterations saved by
+    // the selected one, without recording them in the trace or the attribution counters
+    if (seed_type != SEED_SJODIN) {
+        int seed = seed_type;
+        seed_type = SEED_SJODIN;
+        eval_rts->trace = 0;
+        eval_rts->attribution = 0;
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            int method_id = methods[i].method_id;
+            if (methods[i].enabled == 0 || method_id < RTA_ID || method_id > RTA4_ID) {
+                continue;
+            }
+
+            // the results with the default seed are cached as those of a run with -S sjodin
+            double nsecs;
+            if (cache_file == NULL || no_cache == 1 || cache_replay(eval_rts, method_id, &nsecs) == 0) {
+                struct timespec start, end;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+
+                eval_rts->schedulable[method_id] = (*methods[i].method)(eval_rts);
+
+                clock_gettime(CLOCK_MONOTONIC, &end);
+                if (cache_file != NULL) {
+                    cache_save(eval_rts, method_id, (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec));
+                }
+            }
+            for (j = 0; j < eval_rts->rts_ntask; j++) {
+                seed_while[0][method_id] += eval_rts->tasks[j]->loops_w[method_id];
+                seed_cc[0][method_id] += eval_rts->tasks[j]->cc[method_id];
+            }
+        }
+        seed_type = seed;
+        eval_rts->trace = trace;
+        eval_rts->attribution = attribution;
+        reset_rts(eval_rts);
+    }
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int method_id = methods[i].method_id;
+
+        long heap = 0;
+        if (mem == 1) {
+            heap = heap_in_use();
+            stack_paint(0);
+        }
+
+        // the cache is not used if the stack, the updates of tr or the ceil operations are recorded
+        if (cache_file != NULL && no_cache == 0 && mem == 0 && trace == 0 && attribution == 0 &&
+            method_id != AUTO_ID && cache_replay(eval_rts, method_id, &methods[i].result->nsecs[idx]) == 1) {
+            cached[idx] |= 1 << method_id;
+            cache_hits += 1;
+        } else {
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            eval_rts->schedulable[method_id] = (*methods[i].method)(eval_rts);
+
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            methods[i].result->nsecs[idx] = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+
+            if (cache_file != NULL && method_id != AUTO_ID) {
+                cache_save(eval_rts, method_id, methods[i].result->nsecs[idx]);
+                cache_misses += 1;
+            }
+        }
+
+        if (mem == 1) {
+            long stack = stack_paint(1);
+            heap = heap_in_use() - heap;
+            methods[i].result->stack[idx] = stack;
+            if (stack > methods[i].result->stack_max) {
+                methods[i].result->stack_max = stack;
+            }
+            if (heap > methods[i].result->heap_max) {
+                methods[i].result->heap_max = heap;
+            }
+        }
+
+        // store totals
+        for (j = 0; j < eval_rts->rts_ntask; j++) {
+            struct task_t *task = eval_rts->tasks[j];
+            methods[i].result->cc[idx] += task->cc[method_id];
+            methods[i].result->loops[idx] += task->loops_w[method_id] + task->loops_f[method_id];
+            seed_while[1][method_id] += task->loops_w[method_id];
+            seed_cc[1][method_id] += task->cc[method_id];
+            if (fail_fast_sched == NON_SCHED) {
+                fail_fast_saved[method_id] += task->cc[method_id];
+            }
+        }
+
+        if (fail_fast_sched == NON_SCHED && eval_rts->schedulable[method_id] == SCHED) {
+            fprintf(stderr, "Error! Fail-fast and %s results are not the same. RTS %d\n", methods[i].method_name, rts->rts_id);
+        }
+    }
+
+    // rts with a deadline miss that the fail-fast test did not find
+    if (fail_fast == 1 && fail_fast_sched == SCHED) {
+        for (i = 0; i < NUM_SCHED_METHODS && methods[i].enabled == 0; i++) {
+            ;
+        }
+        if (i < NUM_SCHED_METHODS && eval_rts->schedulable[methods[i].method_id] == NON_SCHED) {
+            fail_fast_missed += 1;
+        }
+    }
+
+    if (methods[AUTO_ID].enabled == 1) {
+        auto_cnt[eval_rts->auto_method] += 1;
+    }
+
+    if (attribution == 1) {
+        attr_report(eval_rts, methods);
+    }
+
+    if (features_file != NULL) {
+        struct features_t f;
+        rts_features(rts, &f);
+        fprintf(features_file, "%d,%d,%f,%f,%d", rts->rts_id, f.n, f.u, f.ratio, f.harmonic);
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (methods[i].enabled == 1) {
+                fprintf(features_file, ",%.0f,%.0f", methods[i].result->nsecs[idx], methods[i].result->cc[idx]);
+            }
+        }
+        fprintf(features_file, "\n");
+    }
+
+    if (eval_rts != rts) {
+        unmerge_rts(rts, eval_rts);
+    }
+
+    if (col_file != NULL) {
+        col_rts_rows(rts, methods, idx);
+    }
+
+#ifdef USE_HDF5
+    if (store_path != NULL) {
+        store_rts_rows(rts, methods, idx);
+    }
+#endif
+}
+
+/*
+ * Mean and standard deviation of the results of each method, over the
+ * num_rts rts evaluated. The rts settled by the screen or the closed form
+ * are left out, as the methods did not run with them, and the time of the
+ * results replayed from the cache, as it was not measured in this run.
+ */
+void result_stats(struct method_t *methods, int num_rts)
+{
+    int i, k, n, n_nsecs;
+    double *v[4];
+
+    for (k = 0; k < 4; k++) {
+        v[k] = malloc(sizeof(double) * (num_rts > 0 ? num_rts : 1));
+    }
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        struct result_t *result = methods[i].result;
+
+        n = n_nsecs = 0;
+        for (k = 0; k < num_rts; k++) {
+            if (settled[k] == 0) {
+                v[0][n] = result->cc[k];
+                v[1][n] = result->loops[k];
+                v[2][n] = result->stack[k];
+                n += 1;
+                if ((cached[k] >> methods[i].method_id & 1) == 0) {
+                    v[3][n_nsecs++] = result->nsecs[k];
+                }
+            }
+        }
+
+        // all the rts settled
+        if (n == 0) {
+            result->cc_mean = result->cc_std = result->loops_mean = result->loops_std = 0;
+            result->stack_mean = result->nsecs_mean = result->nsecs_std = 0;
+            continue;
+        }
+
+        result->cc_mean = gsl_stats_mean(v[0], 1, n);
+        result->cc_std = gsl_stats_sd_m(v[0], 1, n, result->cc_mean);
+        result->loops_mean = gsl_stats_mean(v[1], 1, n);
+        result->loops_std = gsl_stats_sd_m(v[1], 1, n, result->loops_mean);
+        result->stack_mean = gsl_stats_mean(v[2], 1, n);
+        result->nsecs_mean = n_nsecs > 0 ? gsl_stats_mean(v[3], 1, n_nsecs) : 0;
+        result->nsecs_std = n_nsecs > 0 ? gsl_stats_sd_m(v[3], 1, n_nsecs, result->nsecs_mean) : 0;
+    }
+
+    for (k = 0; k < 4; k++) {
+        free(v[k]);
+    }
+}
+
+/*
+ * Evaluate the methods with a rts read from the input file, and the optional
+ * analyses (parametric RTA and OPA).
+ */
+void testRts(struct rts_t *rts, struct method_t *methods)
+{
+    int i;
+
+    // results of the rts evaluated before the last checkpoint
+    if (rts_founded < ckpt_resumed) {
+        checkpoint_restore(rts, methods, rts_founded);
+        rts_founded = rts_founded + 1;
+        return;
+    }
+
+    // evaluate the methods
+    evaluate_rts(rts, methods, rts_founded);
+
+    // wcrt as a function of the wcet of the selected task
+    if (param_task >= 0 && param_task < rts->rts_ntask) {
+        struct task_t *task = rts->tasks[param_task];
+        int lo = (param_lo > 0) ? param_lo : task->c;
+        int hi = (param_hi > 0) ? param_hi : task->d;
+        rta_param(rts, param_task, lo, hi, out_file);
+    }
+
+    // optimal priority assignment
+    if (opa == 1) {
+        int *order = malloc(sizeof(int) * rts->rts_ntask);
+        int opa_sched = opa_assign(rts, order, &opa_cc);
+
+        fprintf(out_file, "OPA: rts %d, %s", rts->rts_id, opa_sched == SCHED ? "sched" : "non sched");
+        if (opa_sched == SCHED) {
+            opa_sched_cnt += 1;
+            fprintf(out_file, ", order:");
+            for (i = 0; i < rts->rts_ntask; i++) {
+                fprintf(out_file, " %d", rts->tasks[order[i]]->id);
+            }
+        }
+        fprintf(out_file, "\n");
+
+        free(order);
+    }
+
+    // aggregates of all the rts (the cost of the methods only of the ones not settled)
+    if (buckets_file != NULL) {
+        bucket_add(rts, methods, rts_founded);
+    }
+    if (sketch_path != NULL) {
+        sketch_rts(methods, rts_founded);
+    }
+
+    if (ckpt_file != NULL) {
+        checkpoint_add(rts, methods, rts_founded);
+    }
+
+    if (telemetry_file != NULL) {
+        telemetry_rts(methods, rts_founded, 0);
+    }
+
+    rts_founded = rts_founded + 1;
+}
+
+/*
+ * Parse the XML file. If a new RTS is found, it is evalutad with the methods in method array.
+ */
+void processXmlFile(xmlTextReaderPtr reader, struct set_t *rts_set, struct method_t *methods)
+{
+    xmlChar *name = xmlTextReaderLocalName(reader);
+
+    // Tag <Set> -- initial tag
+    if (xmlStrcasecmp(name, SET_TAG) == 0) {
+        if (xmlTextReaderNodeType(reader) == ELEMENT) {            
+            xmlChar *c_set_rts_uf = xmlTextReaderGetAttribute(reader, SET_UF_ATTR);
+            xmlChar *c_set_rts_size = xmlTextReaderGetAttribute(reader, SET_SIZE_ATTR);
+            xmlChar *c_set_rts_ntask = xmlTextReaderGetAttribute(reader, SET_RTS_SIZE_ATTR);
+
+            rts_set->set_uf = atoi((char*) c_set_rts_uf);
+            rts_set->set_size = atoi((char*) c_set_rts_size);
+            rts_set->set_rts_ntask = atoi((char*) c_set_rts_ntask);
+
+            xmlFree(c_set_rts_uf);
+            xmlFree(c_set_rts_size);
+            xmlFree(c_set_rts_ntask);
+        }
+    }
+
+    // Tag <S> -- RTS
+    if (xmlStrcasecmp(name, S_TAG) == 0) {
+        if (xmlTextReaderNodeType(reader) == ELEMENT) {
+            xmlChar *c_rts_id = xmlTextReaderGetAttribute(reader, RTS_ID_ATTR);
+            xmlChar *c_rts_uf = xmlTextReaderGetAttribute(reader, RTS_UF_ATTR);
+
+            // reserve memory for the rts and add it to rts_list
+            struct rts_t *new_rts = malloc(sizeof(struct rts_t));            
+
+            // reserve memory for the methods results
+            new_rts->schedulable = malloc(sizeof(int) * NUM_SCHED_METHODS);
+            // reserve memory for the rts tasks
+            new_rts->tasks = malloc(sizeof(struct task_t*) * rts_set->set_rts_ntask);
+
+            // complete data about this rts
+            new_rts->rts_id = atoi((char*) c_rts_id);
+            new_rts->rts_uf = atoi((char*) c_rts_uf);
+            new_rts->rts_ntask = rts_set->set_rts_ntask;
+            new_rts->harmonic = 0;
+            new_rts->chains = 0;
+            new_rts->auto_method = 0;
+            new_rts->trace = 0;
+            new_rts->attribution = 0;
+
+            // add rts to set
+            rts_set->rts_list[rts_founded] = new_rts;
+
+            // free memory
+            xmlFree(c_rts_id);
+            xmlFree(c_rts_uf);
+        }
+
+        if (xmlTextReaderNodeType(reader) == END_ELEMENT) {            
+            testRts(rts_set->rts_list[rts_founded], methods);
+        }
+    }
+
+    // Tag <i> -- a real-time task
+    if (xmlStrcasecmp(name, I_TAG) == 0) {
+        xmlChar *c_id = xmlTextReaderGetAttribute(reader, ID_ATTR);
+        xmlChar *wcet = xmlTextReaderGetAttribute(reader, WCET_ATTR);
+        xmlChar *t = xmlTextReaderGetAttribute(reader, T_ATTR);
+        xmlChar *d = xmlTextReaderGetAttribute(reader, D_ATTR);
+
+        int id = atoi((char*) c_id) - 1;
+
+        struct rts_t *rts = rts_set->rts_list[rts_founded];
+        
+        // reserve memory for the task
+        struct task_t *task = malloc(sizeof(struct task_t));
+
+        // complete the basic task data
+        task->id = id + 1;
+        task->c = atoi((char*) wcet);
+        task->t = atoi((char*) t);
+        task->d = atoi((char*) d);
+        task->tmc = task->t - task->c;
+
+        // add the task to rts
+        rts->tasks[id] = task;
+
+        xmlFree(c_id);
+        xmlFree(wcet);
+        xmlFree(t);
+        xmlFree(d);       
+    }
+
+    xmlFree(name);
+}
+
+/*
+ * Evaluate the schedulability of the rts in the specified xml file.
+ */ 
+void testRtsInXml(char *file, struct set_t* rts_set, struct method_t *methods, int limit)
+{    
+    // get read pointer
+    xmlTextReaderPtr reader = xmlNewTextReaderFilename(file);
+    if (reader == NULL) {
+        fprintf(stderr, "Unable to open %s\n", file);
+        exit(EXIT_FAILURE);
+    }
+
+    // parse xml file and evaluate schedulability methods
+    int ret = xmlTextReaderRead(reader);
+    while (ret == 1) {
+        if (limit > 0 && rts_founded == limit) {
+            break;
+        }
+        processXmlFile(reader, rts_set, methods);
+        ret = xmlTextReaderRead(reader);
+    }
+
+    if (rts_set->set_size < limit) {
+        fprintf(stderr, "Warning: %d str in file according to XML info, but %d to be tested.\n", rts_set->set_size, limit);
+    }
+
+    xmlFreeTextReader(reader);
+}
+
+#ifdef USE_HDF5
+/*
+ * Position of the column col in the values block of a pandas table. The
+ * <block>_kind attribute is the list of names of the columns in the block,
+ * pickled with protocol 0, with one 'V' line for each name. Returns -1 if
+ * the column is not in the block.
+ */
+int hdf5_block_pos(hid_t table, const char *block, const char *col)
+{
+    char attr_name[HDF5_STR_LEN];
+    snprintf(attr_name, HDF5_STR_LEN, "%s_kind", block);
+    if (H5Aexists(table, attr_name) <= 0) {
+        return -1;
+    }
+
+    hid_t attr = H5Aopen(table, attr_name, H5P_DEFAULT);
+    hid_t type = H5Aget_type(attr);
+    char *kind;
+
+    if (H5Tis_variable_str(type) > 0) {
+        char *vlen;
+        hid_t mem_type = H5Tcopy(H5T_C_S1);
+        H5Tset_size(mem_type, H5T_VARIABLE);
+        H5Aread(attr, mem_type, &vlen);
+        kind = strdup(vlen);
+        H5free_memory(vlen);
+        H5Tclose(mem_type);
+    } else {
+        size_t size = H5Tget_size(type);
+        kind = calloc(size + 1, 1);
+        H5Aread(attr, type, kind);
+    }
+
+    H5Tclose(type);
+    H5Aclose(attr);
+
+    int pos = 0;
+    int found = -1;
+    char *saveptr;
+    char *line = strtok_r(kind, "\n", &saveptr);
+    while (line != NULL && found < 0) {
+        if (line[0] == 'a') {
+            line += 1;
+        }
+        if (line[0] == 'V') {
+            if (strcasecmp(line + 1, col) == 0) {
+                found = pos;
+            }
+            pos += 1;
+        }
+        line = strtok_r(NULL, "\n", &saveptr);
+    }
+
+    free(kind);
+
+    return found;
+}
+
+/*
+ * Find the column name in the rows of the table, either as a data column
+ * (a field of the row) or in a values block. The offset is -1 if not found.
+ */
+void hdf5_find_col(hid_t table, hid_t row_type, const char *name, struct hdf5_col *col)
+{
+    strncpy(col->name, name, HDF5_STR_LEN - 1);
+    col->name[HDF5_STR_LEN - 1] = '\0';
+    col->offset = -1;
+
+    int k;
+    int nmembers = H5Tget_nmembers(row_type);
+    for (k = 0; k < nmembers && col->offset < 0; k++) {
+        char *member = H5Tget_member_name(row_type, k);
+        hid_t type = H5Tget_member_type(row_type, k);
+
+        if (strcasecmp(member, name) == 0) {
+            col->offset = H5Tget_member_offset(row_type, k);
+            col->type_class = H5Tget_class(type);
+            col->size = H5Tget_size(type);
+            col->sign = col->type_class == H5T_INTEGER ? H5Tget_sign(type) : H5T_SGN_NONE;
+        } else if (strncmp(member, "values_block_", 13) == 0 && H5Tget_class(type) == H5T_ARRAY) {
+            int pos = hdf5_block_pos(table, member, name);
+            if (pos >= 0) {
+                hid_t base = H5Tget_super(type);
+                col->type_class = H5Tget_class(base);
+                col->size = H5Tget_size(base);
+                col->sign = col->type_class == H5T_INTEGER ? H5Tget_sign(base) : H5T_SGN_NONE;
+                col->offset = H5Tget_member_offset(row_type, k) + pos * col->size;
+                H5Tclose(base);
+            }
+        }
+
+        H5Tclose(type);
+        H5free_memory(member);
+    }
+}
+
+/*
+ * Value of a numeric column in a row.
+ */
+double hdf5_value(const char *row, struct hdf5_col *col)
+{
+    const char *p = row + col->offset;
+
+    if (col->type_class == H5T_FLOAT) {
+        if (col->size == sizeof(float)) {
+            float v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+        double v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    if (col->type_class == H5T_INTEGER) {
+        int64_t v = 0;
+        switch (col->size) {
+            case 1: { int8_t x; memcpy(&x, p, 1); v = col->sign == H5T_SGN_NONE ? (uint8_t) x : x; break; }
+            case 2: { int16_t x; memcpy(&x, p, 2); v = col->sign == H5T_SGN_NONE ? (uint16_t) x : x; break; }
+            case 4: { int32_t x; memcpy(&x, p, 4); v = col->sign == H5T_SGN_NONE ? (uint32_t) x : x; break; }
+            case 8: memcpy(&v, p, 8); break;
+        }
+        return (double) v;
+    }
+
+    return 0.0;
+}
+
+/*
+ * Value of a string column in a row, into str (HDF5_STR_LEN bytes).
+ */
+void hdf5_str(const char *row, struct hdf5_col *col, char *str)
+{
+    size_t len = col->size < HDF5_STR_LEN - 1 ? col->size : HDF5_STR_LEN - 1;
+    memcpy(str, row + col->offset, len);
+    str[len] = '\0';
+}
+
+/*
+ * Parse the where condition into terms. Returns the number of terms, or -1
+ * if the condition is not valid.
+ */
+int hdf5_parse_where(char *where, hid_t table, hid_t row_type, struct hdf5_term *terms)
+{
+    int n = 0;
+    char *copy = strdup(where);
+    char *saveptr;
+    char *term = strtok_r(copy, "&", &saveptr);
+
+    while (term != NULL) {
+        struct hdf5_term *t = &terms[n];
+        char name[HDF5_STR_LEN];
+        int len = 0;
+
+        if (n == HDF5_MAX_TERMS) {
+            n = -1;
+            break;
+        }
+
+        while (*term == ' ') {
+            term++;
+        }
+        while ((isalnum(*term) || *term == '_') && len < HDF5_STR_LEN - 1) {
+            name[len++] = *term++;
+        }
+        name[len] = '\0';
+        while (*term == ' ') {
+            term++;
+        }
+
+        len = 0;
+        while (strchr("=!<>", *term) != NULL && *term != '\0' && len < 2) {
+            t->op[len++] = *term++;
+        }
+        t->op[len] = '\0';
+        if (strcmp(t->op, "=") == 0) {
+            strcpy(t->op, "==");
+        }
+        while (*term == ' ') {
+            term++;
+        }
+
+        t->is_str = (*term == '\'' || *term == '"');
+        if (t->is_str) {
+            char quote = *term++;
+            char *end = strchr(term, quote);
+            if (end == NULL) {
+                n = -1;
+                break;
+            }
+            len = (end - term) < HDF5_STR_LEN - 1 ? (end - term) : HDF5_STR_LEN - 1;
+            memcpy(t->str, term, len);
+            t->str[len] = '\0';
+        } else {
+            char *end;
+            t->value = strtod(term, &end);
+            if (end == term) {
+                n = -1;
+                break;
+            }
+        }
+
+        hdf5_find_col(table, row_type, name, &t->col);
+        if (t->col.offset < 0 || (t->is_str && t->col.type_class != H5T_STRING) ||
+            (strcmp(t->op, "==") && strcmp(t->op, "!=") && strcmp(t->op, "<") &&
+             strcmp(t->op, "<=") && strcmp(t->op, ">") && strcmp(t->op, ">="))) {
+            fprintf(stderr, "Invalid term in where condition: %s %s\n", name, t->op);
+            n = -1;
+            break;
+        }
+
+        n += 1;
+        term = strtok_r(NULL, "&", &saveptr);
+    }
+
+    free(copy);
+
+    return n;
+}
+
+/*
+ * Check if the row meets all the terms of the where condition.
+ */
+int hdf5_match(const char *row, struct hdf5_term *terms, int num_terms)
+{
+    char str[HDF5_STR_LEN];
+    int k;
+
+    for (k = 0; k < num_terms; k++) {
+        struct hdf5_term *t = &terms[k];
+        int cmp;
+
+        if (t->is_str) {
+            hdf5_str(row, &t->col, str);
+            cmp = strcmp(str, t->str);
+        } else {
+            double v = hdf5_value(row, &t->col);
+            cmp = (v > t->value) - (v < t->value);
+        }
+
+        if ((strcmp(t->op, "==") == 0 && cmp != 0) || (strcmp(t->op, "!=") == 0 && cmp == 0) ||
+            (strcmp(t->op, "<") == 0 && cmp >= 0) || (strcmp(t->op, "<=") == 0 && cmp > 0) ||
+            (strcmp(t->op, ">") == 0 && cmp <= 0) || (strcmp(t->op, ">=") == 0 && cmp < 0)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Add a rts read from a HDF5 store to the set, and evaluate it. The tasks are
+ * copied from the tasks array.
+ */
+void hdf5_add_rts(struct set_t *rts_set, struct method_t *methods, struct task_t **tasks, int ntask, int rts_id, int uf)
+{
+    struct rts_t *new_rts = malloc(sizeof(struct rts_t));
+
+    new_rts->schedulable = malloc(sizeof(int) * NUM_SCHED_METHODS);
+    new_rts->tasks = malloc(sizeof(struct task_t*) * ntask);
+    memcpy(new_rts->tasks, tasks, sizeof(struct task_t*) * ntask);
+
+    new_rts->rts_id = rts_id > 0 ? rts_id : rts_founded + 1;
+    new_rts->rts_uf = uf;
+    new_rts->rts_ntask = ntask;
+    new_rts->harmonic = 0;
+    new_rts->chains = 0;
+    new_rts->auto_method = 0;
+    new_rts->trace = 0;
+    new_rts->attribution = 0;
+
+    if (rts_founded == 0) {
+        rts_set->set_uf = uf;
+        rts_set->set_rts_ntask = ntask;
+    }
+    rts_set->set_size += 1;
+    rts_set->rts_list[rts_founded] = new_rts;
+
+    testRts(new_rts, methods);
+}
+
+/*
+ * Evaluate the schedulability of the rts in the table key of the specified
+ * HDF5 store, written by pandas with format='table'. Only the rows that meet
+ * the where condition are used. The rows are read in chunks, so the table is
+ * never loaded in memory.
+ */
+void testRtsInHdf5(char *file, char *key, char *where, struct set_t* rts_set, struct method_t *methods, int limit)
+{
+    // the first HDF5_NUM_GROUP columns identify each rts, as in wcrt-test-mbed.py
+    static const char *col_names[HDF5_NUM_COLS] = {"tdist", "trange", "ntask", "uf", "rts_id", "c", "t", "d"};
+    struct hdf5_col cols[HDF5_NUM_COLS];
+    struct hdf5_term terms[HDF5_MAX_TERMS];
+    int num_terms = 0;
+
+    // errors are reported below
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    hid_t h5file = H5Fopen(file, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (h5file < 0) {
+        fprintf(stderr, "Unable to open %s\n", file);
+        exit(EXIT_FAILURE);
+    }
+
+    char path[strlen(key) + 8];
+    sprintf(path, "%s/table", key);
+    hid_t table = H5Dopen2(h5file, path, H5P_DEFAULT);
+    if (table < 0) {
+        fprintf(stderr, "%s: table %s not found\n", file, key);
+        exit(EXIT_FAILURE);
+    }
+
+    hid_t file_type = H5Dget_type(table);
+    hid_t row_type = H5Tget_native_type(file_type, H5T_DIR_ASCEND);
+    size_t row_size = H5Tget_size(row_type);
+
+    int k;
+    for (k = 0; k < HDF5_NUM_COLS; k++) {
+        hdf5_find_col(table, row_type, col_names[k], &cols[k]);
+        if (k >= HDF5_COL_C && cols[k].offset < 0) {
+            fprintf(stderr, "%s: column %s not found in %s\n", file, col_names[k], key);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (where != NULL) {
+        num_terms = hdf5_parse_where(where, table, row_type, terms);
+        if (num_terms < 0) {
+            fprintf(stderr, "Invalid where condition: %s\n", where);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    hid_t space = H5Dget_space(table);
+    hsize_t num_rows;
+    H5Sget_simple_extent_dims(space, &num_rows, NULL);
+
+    char *buf = malloc(row_size * HDF5_CHUNK_ROWS);
+
+    // tasks of the current rts, and the values of its group columns
+    int ntask = 0;
+    int size = 16;
+    struct task_t **tasks = malloc(sizeof(struct task_t*) * size);
+    double group[HDF5_NUM_GROUP] = {0};
+    char group_str[HDF5_NUM_GROUP][HDF5_STR_LEN];
+
+    hsize_t start;
+    for (start = 0; start < num_rows && rts_founded < limit; start += HDF5_CHUNK_ROWS) {
+        hsize_t count = (num_rows - start) < HDF5_CHUNK_ROWS ? (num_rows - start) : HDF5_CHUNK_ROWS;
+        hid_t mem_space = H5Screate_simple(1, &count, NULL);
+        H5Sselect_hyperslab(space, H5S_SELECT_SET, &start, NULL, &count, NULL);
+        if (H5Dread(table, row_type, mem_space, space, H5P_DEFAULT, buf) < 0) {
+            fprintf(stderr, "%s: unable to read %s\n", file, key);
+            exit(EXIT_FAILURE);
+        }
+        H5Sclose(mem_space);
+
+        hsize_t r;
+        for (r = 0; r < count && rts_founded < limit; r++) {
+            char *row = buf + r * row_size;
+
+            if (hdf5_match(row, terms, num_terms) == 0) {
+                continue;
+            }
+
+            // a change in the group columns ends the current rts
+            double values[HDF5_NUM_GROUP];
+            char strs[HDF5_NUM_GROUP][HDF5_STR_LEN];
+            int same = (ntask > 0);
+            for (k = 0; k < HDF5_NUM_GROUP; k++) {
+                values[k] = 0.0;
+                strs[k][0] = '\0';
+                if (cols[k].offset < 0) {
+                    continue;
+                }
+                if (cols[k].type_class == H5T_STRING) {
+                    hdf5_str(row, &cols[k], strs[k]);
+                    same = same && strcmp(strs[k], group_str[k]) == 0;
+                } else {
+                    values[k] = hdf5_value(row, &cols[k]);
+                    same = same && values[k] == group[k];
+                }
+            }
+
+            if (same == 0 && ntask > 0) {
+                hdf5_add_rts(rts_set, methods, tasks, ntask, (int) group[4], (int) group[3]);
+                ntask = 0;
+                if (rts_founded == limit) {
+                    break;
+                }
+            }
+
+            memcpy(group, values, sizeof(group));
+            memcpy(group_str, strs, sizeof(group_str));
+
+            if (ntask == size) {
+                size *= 2;
+                tasks = realloc(tasks, sizeof(struct task_t*) * size);
+            }
+
+            struct task_t *task = malloc(sizeof(struct task_t));
+            task->id = ntask + 1;
+            task->c = (int) hdf5_value(row, &cols[HDF5_COL_C]);
+            task->t = (int) hdf5_value(row, &cols[HDF5_COL_T]);
+            task->d = (int) hdf5_value(row, &cols[HDF5_COL_D]);
+            task->tmc = task->t - task->c;
+            tasks[ntask] = task;
+            ntask += 1;
+        }
+    }
+
+    if (ntask > 0) {
+        hdf5_add_rts(rts_set, methods, tasks, ntask, (int) group[4], (int) group[3]);
+    }
+
+    if (rts_founded < limit) {
+        fprintf(stderr, "Warning: %d rts in %s, but %d to be tested.\n", rts_founded, key, limit);
+    }
+
+    free(tasks);
+    free(buf);
+    H5Sclose(space);
+    H5Tclose(row_type);
+    H5Tclose(file_type);
+    H5Dclose(table);
+    H5Fclose(h5file);
+}
+#endif
+
+/*
+ * Add a value to the running statistics.
+ */
+void stats_add(struct stats_t *st, double x)
+{
+    int i;
+
+    st->n += 1;
+    double delta = x - st->mean;
+    st->mean += delta / st->n;
+    st->m2 += delta * (x - st->mean);
+
+    if (st->n == 1 || x < st->min) {
+        st->min = x;
+    }
+    if (st->n == 1 || x > st->max) {
+        st->max = x;
+    }
+
+    // P2 median: the first 5 values are the initial markers
+    if (st->n <= 5) {
+        st->q[st->n - 1] = x;
+        if (st->n == 5) {
+            gsl_sort(st->q, 1, 5);
+            for (i = 0; i < 5; i++) {
+                st->pos[i] = i + 1;
+            }
+            st->want[0] = 1;
+            st->want[1] = 2;
+            st->want[2] = 3;
+            st->want[3] = 4;
+            st->want[4] = 5;
+        }
+        return;
+    }
+
+    // cell of x, adjusting the extreme markers
+    int k;
+    if (x < st->q[0]) {
+        st->q[0] = x;
+        k = 0;
+    } else if (x >= st->q[4]) {
+        st->q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; x >= st->q[k + 1]; k++) {
+            ;
+        }
+    }
+
+    static const double inc[5] = {0.0, 0.25, 0.5, 0.75, 1.0};
+    for (i = k + 1; i < 5; i++) {
+        st->pos[i] += 1;
+    }
+    for (i = 0; i < 5; i++) {
+        st->want[i] += inc[i];
+    }
+
+    // move the middle markers towards their desired positions
+    for (i = 1; i < 4; i++) {
+        double d = st->want[i] - st->pos[i];
+        if ((d >= 1 && st->pos[i + 1] - st->pos[i] > 1) || (d <= -1 && st->pos[i - 1] - st->pos[i] < -1)) {
+            int s = d > 0 ? 1 : -1;
+            double qp = st->q[i] + s / (st->pos[i + 1] - st->pos[i - 1]) *
+                        ((st->pos[i] - st->pos[i - 1] + s) * (st->q[i + 1] - st->q[i]) / (st->pos[i + 1] - st->pos[i]) +
+                         (st->pos[i + 1] - st->pos[i] - s) * (st->q[i] - st->q[i - 1]) / (st->pos[i] - st->pos[i - 1]));
+            if (st->q[i - 1] < qp && qp < st->q[i + 1]) {
+                st->q[i] = qp;
+            } else {
+                st->q[i] += s * (st->q[i + s] - st->q[i]) / (st->pos[i + s] - st->pos[i]);
+            }
+            st->pos[i] += s;
+        }
+    }
+}
+
+/*
+ * Median of the values added, exact for up to 5 values.
+ */
+double stats_median(struct stats_t *st)
+{
+    if (st->n >= 5) {
+        return st->q[2];
+    }
+
+    double q[5];
+    memcpy(q, st->q, sizeof(double) * st->n);
+    gsl_sort(q, 1, st->n);
+    return gsl_stats_median_from_sorted_data(q, 1, st->n);
+}
+
+/*
+ * Add the results of the enabled methods with the rts to its (uf, ntask)
+ * bucket.
+ */
+void bucket_add(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int b, i;
+
+    for (b = 0; b < num_buckets; b++) {
+        if (buckets[b].uf == rts->rts_uf && buckets[b].ntask == rts->rts_ntask) {
+            break;
+        }
+    }
+    if (b == num_buckets) {
+        buckets = realloc(buckets, sizeof(struct bucket_t) * (num_buckets + 1));
+        memset(&buckets[b], 0, sizeof(struct bucket_t));
+        buckets[b].uf = rts->rts_uf;
+        buckets[b].ntask = rts->rts_ntask;
+        num_buckets += 1;
+    }
+
+    struct bucket_t *bucket = &buckets[b];
+    bucket->count += 1;
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int m = methods[i].method_id;
+        struct result_t *result = methods[i].result;
+
+        if (rts->schedulable[m] == SCHED) {
+            bucket->sched[m] += 1;
+        }
+        if (settled[idx] == 1) {
+            continue;
+        }
+        stats_add(&bucket->stats[m][BUCKET_CC], result->cc[idx]);
+        stats_add(&bucket->stats[m][BUCKET_LOOPS], result->loops[idx]);
+        if ((cached[idx] >> m & 1) == 0) {
+            stats_add(&bucket->stats[m][BUCKET_NSECS], result->nsecs[idx]);
+        }
+    }
+}
+
+/*
+ * Write the metrics of each bucket and method to buckets_file, as CSV.
+ */
+void bucket_report(struct method_t *methods)
+{
+    int b, i, k;
+
+    fprintf(buckets_file, "method,uf,ntask,count,sched_ratio");
+    for (k = 0; k < NUM_BUCKET_METRICS; k++) {
+        fprintf(buckets_file, ",%1$s_mean,%1$s_sd,%1$s_min,%1$s_max,%1$s_median", metric_names[k]);
+    }
+    fprintf(buckets_file, "\n");
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int m = methods[i].method_id;
+
+        for (b = 0; b < num_buckets; b++) {
+            struct bucket_t *bucket = &buckets[b];
+            fprintf(buckets_file, "%s,%d,%d,%ld,%f", methods[i].method_name, bucket->uf, bucket->ntask, bucket->count,
+                    (double) bucket->sched[m] / bucket->count);
+            for (k = 0; k < NUM_BUCKET_METRICS; k++) {
+                struct stats_t *st = &bucket->stats[m][k];
+                double sd = st->n > 1 ? sqrt(st->m2 / (st->n - 1)) : 0.0;
+                fprintf(buckets_file, ",%f,%f,%.0f,%.0f,%f", st->mean, sd, st->min, st->max, stats_median(st));
+            }
+            fprintf(buckets_file, "\n");
+        }
+    }
+}
+
+/*
+ * Bucket of a value in a sketch.
+ */
+int sketch_index(uint64_t v)
+{
+    if (v < SKETCH_SUB_COUNT) {
+        return (int) v;
+    }
+
+    int e = 63 - __builtin_clzll(v) - SKETCH_SUB_BITS;
+    return e * SKETCH_SUB_COUNT + (int) (v >> e);
+}
+
+/*
+ * Lowest value of a bucket in a sketch.
+ */
+uint64_t sketch_value(int index)
+{
+    if (index < SKETCH_SUB_COUNT) {
+        return index;
+    }
+
+    int e = index / SKETCH_SUB_COUNT - 1;
+    return (uint64_t) (index - e * SKETCH_SUB_COUNT) << e;
+}
+
+/*
+ * Add count times the value v to the sketch.
+ */
+void sketch_add(struct sketch_t *sk, uint64_t v, uint64_t count)
+{
+    if (sk->counts == NULL) {
+        sk->counts = calloc(SKETCH_BUCKETS, sizeof(uint64_t));
+    }
+
+    if (sk->count == 0 || v < sk->min) {
+        sk->min = v;
+    }
+    if (sk->count == 0 || v > sk->max) {
+        sk->max = v;
+    }
+    sk->count += count;
+    sk->counts[sketch_index(v)] += count;
+}
+
+/*
+ * Add the values of the sketch src to dst.
+ */
+void sketch_merge(struct sketch_t *dst, struct sketch_t *src)
+{
+    int i;
+
+    if (src->count == 0) {
+        return;
+    }
+    if (dst->counts == NULL) {
+        dst->counts = calloc(SKETCH_BUCKETS, sizeof(uint64_t));
+    }
+
+    if (dst->count == 0 || src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (dst->count == 0 || src->max > dst->max) {
+        dst->max = src->max;
+    }
+    dst->count += src->count;
+    for (i = 0; i < SKETCH_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+}
+
+/*
+ * Value of the q quantile (0 < q <= 1): the middle of the bucket with the
+ * value of rank ceil(q * count), within the min and max of the sketch.
+ */
+uint64_t sketch_quantile(struct sketch_t *sk, double q)
+{
+    int i;
+
+    if (sk->count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t) ceil(q * sk->count);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t cum = 0;
+    for (i = 0; i < SKETCH_BUCKETS - 1; i++) {
+        cum += sk->counts[i];
+        if (cum >= rank) {
+            break;
+        }
+    }
+
+    uint64_t v = sketch_value(i) + (sketch_value(i + 1) - sketch_value(i) - 1) / 2;
+    if (v < sk->min) {
+        v = sk->min;
+    }
+    if (v > sk->max) {
+        v = sk->max;
+    }
+    return v;
+}
+
+/*
+ * Add the results of the enabled methods with the rts to their sketches.
+ */
+void sketch_rts(struct method_t *methods, int idx)
+{
+    int i;
+
+    // the methods did not run
+    if (settled[idx] == 1) {
+        return;
+    }
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int m = methods[i].method_id;
+        struct result_t *result = methods[i].result;
+
+        sketch_add(&sketches[m][BUCKET_CC], (uint64_t) result->cc[idx], 1);
+        sketch_add(&sketches[m][BUCKET_LOOPS], (uint64_t) result->loops[idx], 1);
+        if ((cached[idx] >> m & 1) == 0) {
+            sketch_add(&sketches[m][BUCKET_NSECS], (uint64_t) (result->nsecs[idx] > 0 ? result->nsecs[idx] : 0), 1);
+        }
+    }
+}
+
+/*
+ * Sketch with the method and metric names in the saved sketches, added if
+ * not found.
+ */
+struct sketch_t *sketch_find(struct saved_sketch_t **saved, int *num_saved, char names[2][8])
+{
+    int k;
+
+    for (k = 0; k < *num_saved; k++) {
+        if (memcmp((*saved)[k].names, names, 16) == 0) {
+            return &(*saved)[k].sk;
+        }
+    }
+
+    *saved = realloc(*saved, (*num_saved + 1) * sizeof(struct saved_sketch_t));
+    memset(&(*saved)[*num_saved], 0, sizeof(struct saved_sketch_t));
+    memcpy((*saved)[*num_saved].names, names, 16);
+    return &(*saved)[(*num_saved)++].sk;
+}
+
+/*
+ * Read all the sketches saved in a file, of any method and metric (for
+ * example, the cycles and usecs of the board saved by wcrt-test-mbed.py).
+ * Returns the number of sketches, 0 if the file does not exist.
+ */
+int sketch_load(char *path, struct saved_sketch_t **saved)
+{
+    char magic[8];
+    char names[2][8];
+    uint32_t sub_bits, num_sketches, num_buckets, k, b;
+    uint64_t hdr[3], pair[2];
+    int num_saved = 0;
+
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        if (errno == ENOENT) {
+            return 0;
+        }
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+
+    if (fread(magic, 8, 1, f) != 1 || memcmp(magic, SKETCH_MAGIC, 8) != 0 ||
+        fread(&sub_bits, 4, 1, f) != 1 || fread(&num_sketches, 4, 1, f) != 1) {
+        fprintf(stderr, "%s: not a sketches file.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (sub_bits != SKETCH_SUB_BITS) {
+        fprintf(stderr, "%s: sketches with %u sub-bucket bits, expected %d.\n", path, sub_bits, SKETCH_SUB_BITS);
+        exit(EXIT_FAILURE);
+    }
+
+    for (k = 0; k < num_sketches; k++) {
+        if (fread(names, 8, 2, f) != 2 || fread(hdr, 8, 3, f) != 3 || fread(&num_buckets, 4, 1, f) != 1) {
+            fprintf(stderr, "%s: truncated sketch %u.\n", path, k);
+            exit(EXIT_FAILURE);
+        }
+
+        struct sketch_t sk = {hdr[0], hdr[1], hdr[2], calloc(SKETCH_BUCKETS, sizeof(uint64_t))};
+        for (b = 0; b < num_buckets; b++) {
+            if (fread(pair, 8, 2, f) != 2 || pair[0] >= SKETCH_BUCKETS) {
+                fprintf(stderr, "%s: corrupted sketch %u.\n", path, k);
+                exit(EXIT_FAILURE);
+            }
+            sk.counts[pair[0]] = pair[1];
+        }
+
+        sketch_merge(sketch_find(saved, &num_saved, names), &sk);
+        free(sk.counts);
+    }
+
+    fclose(f);
+
+    return num_saved;
+}
+
+/*
+ * Save the sketches into path.tmp, renamed to path once complete, so that
+ * an interrupted run does not leave a truncated file.
+ */
+void sketch_save(char *path, struct saved_sketch_t *saved, int num_saved)
+{
+    uint32_t header[2] = {SKETCH_SUB_BITS, num_saved};
+    char tmp_path[strlen(path) + 5];
+    int k, b;
+
+    sprintf(tmp_path, "%s.tmp", path);
+    FILE *f = fopen(tmp_path, "wb");
+    if (f == NULL) {
+        perror(tmp_path);
+        exit(EXIT_FAILURE);
+    }
+
+    fwrite(SKETCH_MAGIC, 8, 1, f);
+    fwrite(header, 4, 2, f);
+
+    for (k = 0; k < num_saved; k++) {
+        struct sketch_t *sk = &saved[k].sk;
+        uint64_t hdr[3] = {sk->count, sk->min, sk->max};
+        uint32_t num_buckets = 0;
+        for (b = 0; sk->counts != NULL && b < SKETCH_BUCKETS; b++) {
+            num_buckets += sk->counts[b] > 0;
+        }
+
+        fwrite(saved[k].names, 8, 2, f);
+        fwrite(hdr, 8, 3, f);
+        fwrite(&num_buckets, 4, 1, f);
+        for (b = 0; sk->counts != NULL && b < SKETCH_BUCKETS; b++) {
+            if (sk->counts[b] > 0) {
+                uint64_t pair[2] = {b, sk->counts[b]};
+                fwrite(pair, 8, 2, f);
+            }
+        }
+    }
+
+    if (fclose(f) != 0 || rename(tmp_path, path) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * Merge the sketches of the enabled methods into the sketches saved in the
+ * file, keeping those of other methods and metrics, so that runs on several
+ * shards can share the same file. The merge holds an exclusive flock on
+ * path.lock, so concurrent runs on the same host do not lose each other's
+ * sketches (flock may not be honoured across hosts on a network filesystem).
+ */
+void sketch_update(char *path, struct method_t *methods)
+{
+    struct saved_sketch_t *saved = NULL;
+    char lock_path[strlen(path) + 6];
+    int i, j, k;
+
+    sprintf(lock_path, "%s.lock", path);
+    int lock_fd = open(lock_path, O_RDWR | O_CREAT, 0644);
+    if (lock_fd == -1 || flock(lock_fd, LOCK_EX) != 0) {
+        perror(lock_path);
+        exit(EXIT_FAILURE);
+    }
+
+    int num_saved = sketch_load(path, &saved);
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        for (j = 0; j < NUM_BUCKET_METRICS; j++) {
+            char names[2][8] = {{0}};
+            strncpy(names[0], methods[i].method_name, 7);
+            strncpy(names[1], metric_names[j], 7);
+            sketch_merge(sketch_find(&saved, &num_saved, names), &sketches[methods[i].method_id][j]);
+        }
+    }
+
+    sketch_save(path, saved, num_saved);
+
+    // the lock is released when closed
+    close(lock_fd);
+
+    for (k = 0; k < num_saved; k++) {
+        free(saved[k].sk.counts);
+    }
+    free(saved);
+}
+
+/*
+ * Key of the results of a method with a rts: FNV-1a and a splitmix64 based
+ * hash of the method, its version, the options that change the counters,
+ * and the C, T and D of the tasks.
+ */
+void cache_key(struct rts_t *rts, int method_id, uint64_t *key)
+{
+    int i, k;
+
+    int64_t words[6 + 3 * rts->rts_ntask];
+    words[0] = method_id;
+    words[1] = method_versions[method_id];
+    words[2] = CEIL_TYPE;
+    words[3] = seed_type;
+    words[4] = method_id == RTA4A_ID ? budget_type * 1000000007L + budget : 0;
+    words[5] = rts->rts_ntask;
+    for (i = 0; i < rts->rts_ntask; i++) {
+        words[6 + 3 * i] = rts->tasks[i]->c;
+        words[7 + 3 * i] = rts->tasks[i]->t;
+        words[8 + 3 * i] = rts->tasks[i]->d;
+    }
+
+    uint64_t h1 = 14695981039346656037ULL;
+    uint64_t h2 = 0;
+    for (k = 0; k < 6 + 3 * rts->rts_ntask; k++) {
+        for (i = 0; i < 8; i++) {
+            h1 = (h1 ^ (((uint64_t) words[k] >> (8 * i)) & 0xff)) * 1099511628211ULL;
+        }
+        uint64_t z = h2 + (uint64_t) words[k] + 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        h2 = z ^ (z >> 31);
+    }
+
+    key[0] = h1;
+    key[1] = h2;
+}
+
+/*
+ * Cached results with the key, or NULL.
+ */
+struct cache_rec *cache_find(uint64_t *key)
+{
+    if (cache_num_slots == 0) {
+        return NULL;
+    }
+
+    long slot = key[0] & (cache_num_slots - 1);
+    while (cache_slots[slot] >= 0) {
+        struct cache_rec *rec = &cache_recs[cache_slots[slot]];
+        if (rec->key[0] == key[0] && rec->key[1] == key[1]) {
+            return rec;
+        }
+        slot = (slot + 1) & (cache_num_slots - 1);
+    }
+
+    return NULL;
+}
+
+/*
+ * Add the record to the cache, replacing the one with the same key.
+ */
+void cache_insert(struct cache_rec *rec)
+{
+    long i;
+
+    struct cache_rec *old = cache_find(rec->key);
+    if (old != NULL) {
+        free(old->tasks);
+        *old = *rec;
+        return;
+    }
+
+    // keep the hash table at most half full
+    if (2 * (cache_len + 1) > cache_num_slots) {
+        cache_num_slots = cache_num_slots == 0 ? CACHE_MIN_SLOTS : 2 * cache_num_slots;
+        cache_slots = realloc(cache_slots, sizeof(long) * cache_num_slots);
+        for (i = 0; i < cache_num_slots; i++) {
+            cache_slots[i] = -1;
+        }
+        for (i = 0; i < cache_len; i++) {
+            long slot = cache_recs[i].key[0] & (cache_num_slots - 1);
+            while (cache_slots[slot] >= 0) {
+                slot = (slot + 1) & (cache_num_slots - 1);
+            }
+            cache_slots[slot] = i;
+        }
+        cache_recs = realloc(cache_recs, sizeof(struct cache_rec) * cache_num_slots / 2);
+    }
+
+    long slot = rec->key[0] & (cache_num_slots - 1);
+    while (cache_slots[slot] >= 0) {
+        slot = (slot + 1) & (cache_num_slots - 1);
+    }
+    cache_slots[slot] = cache_len;
+    cache_recs[cache_len] = *rec;
+    cache_len += 1;
+}
+
+/*
+ * Load the records of the cache file (if exists), and open it to append
+ * the new results.
+ */
+void cache_open(char *path)
+{
+    char magic[8];
+
+    FILE *f = fopen(path, "rb");
+    if (f != NULL) {
+        if (fread(magic, 8, 1, f) != 1 || memcmp(magic, CACHE_MAGIC, 8) != 0) {
+            fprintf(stderr, "%s: not a cache file.\n", path);
+            exit(EXIT_FAILURE);
+        }
+
+        // an incomplete last record (an interrupted run) is ignored
+        struct cache_rec rec;
+        while (fread(rec.key, 8, 2, f) == 2 && fread(&rec.ntask, 4, 1, f) == 1 && fread(&rec.sched, 4, 1, f) == 1 &&
+               fread(&rec.nsecs, 8, 1, f) == 1 && rec.ntask > 0) {
+            rec.tasks = malloc(sizeof(int32_t) * 4 * rec.ntask);
+            if (fread(rec.tasks, sizeof(int32_t) * 4, rec.ntask, f) != (size_t) rec.ntask) {
+                free(rec.tasks);
+                break;
+            }
+            cache_insert(&rec);
+        }
+        fclose(f);
+    } else if (errno != ENOENT) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+
+    cache_file = fopen(path, "ab");
+    if (cache_file == NULL) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (ftell(cache_file) == 0) {
+        fwrite(CACHE_MAGIC, 1, 8, cache_file);
+    }
+}
+
+/*
+ * Copy the cached results of the method into the rts. Returns 0 if they are
+ * not in the cache.
+ */
+int cache_replay(struct rts_t *rts, int method_id, double *nsecs)
+{
+    uint64_t key[2];
+    int i;
+
+    cache_key(rts, method_id, key);
+    struct cache_rec *rec = cache_find(key);
+    if (rec == NULL || rec->ntask != rts->rts_ntask) {
+        return 0;
+    }
+
+    rts->schedulable[method_id] = rec->sched;
+    for (i = 0; i < rec->ntask; i++) {
+        struct task_t *task = rts->tasks[i];
+        task->wcrt[method_id] = rec->tasks[4 * i];
+        task->cc[method_id] = rec->tasks[4 * i + 1];
+        task->loops_w[method_id] = rec->tasks[4 * i + 2];
+        task->loops_f[method_id] = rec->tasks[4 * i + 3];
+    }
+    *nsecs = rec->nsecs;
+
+    return 1;
+}
+
+/*
+ * Save the results of the method with the rts into the cache.
+ */
+void cache_save(struct rts_t *rts, int method_id, double nsecs)
+{
+    struct cache_rec rec;
+    int i;
+
+    cache_key(rts, method_id, rec.key);
+    rec.ntask = rts->rts_ntask;
+    rec.sched = rts->schedulable[method_id];
+    rec.nsecs = nsecs;
+    rec.tasks = malloc(sizeof(int32_t) * 4 * rec.ntask);
+    for (i = 0; i < rec.ntask; i++) {
+        struct task_t *task = rts->tasks[i];
+        rec.tasks[4 * i] = task->wcrt[method_id];
+        rec.tasks[4 * i + 1] = task->cc[method_id];
+        rec.tasks[4 * i + 2] = task->loops_w[method_id];
+        rec.tasks[4 * i + 3] = task->loops_f[method_id];
+    }
+
+    fwrite(rec.key, 8, 2, cache_file);
+    fwrite(&rec.ntask, 4, 1, cache_file);
+    fwrite(&rec.sched, 4, 1, cache_file);
+    fwrite(&rec.nsecs, 8, 1, cache_file);
+    fwrite(rec.tasks, sizeof(int32_t) * 4, rec.ntask, cache_file);
+
+    cache_insert(&rec);
+}
+
+/*
+ * Size of the results of a rts in a checkpoint: schedulability of each
+ * method, settled, cached, and cc, loops, nsecs and stack of each method.
+ */
+#define CKPT_ROW_SIZE       (sizeof(int32_t) * (NUM_SCHED_METHODS + 2) + sizeof(double) * 4 * NUM_SCHED_METHODS)
+
+// counters saved in each checkpoint
+struct ckpt_var {
+    void *p;
+    size_t size;
+};
+
+struct ckpt_var ckpt_vars[] = {
+    {&opa_sched_cnt, sizeof(opa_sched_cnt)}, {&opa_cc, sizeof(opa_cc)},
+    {screen_cnt, sizeof(screen_cnt)},
+    {seed_while, sizeof(seed_while)}, {seed_cc, sizeof(seed_cc)},
+    {&harmonic_cnt, sizeof(harmonic_cnt)}, {&harmonic_cc, sizeof(harmonic_cc)}, {&settled_cnt, sizeof(settled_cnt)},
+    {&merged_cnt, sizeof(merged_cnt)}, {&merged_tasks, sizeof(merged_tasks)}, {&chains_sum, sizeof(chains_sum)},
+    {&fail_fast_cnt, sizeof(fail_fast_cnt)}, {&fail_fast_missed, sizeof(fail_fast_missed)},
+    {&fail_fast_cc, sizeof(fail_fast_cc)},
+    {fail_fast_saved, sizeof(fail_fast_saved)},
+    {auto_cnt, sizeof(auto_cnt)},
+    {&rta4a_slices, sizeof(rta4a_slices)}, {&rta4a_slices_max, sizeof(rta4a_slices_max)},
+    {&cache_hits, sizeof(cache_hits)}, {&cache_misses, sizeof(cache_misses)},
+};
+
+#define NUM_CKPT_VARS       (sizeof(ckpt_vars) / sizeof(struct ckpt_var))
+
+/*
+ * Open the checkpoints file. With --resume, the results and counters of the
+ * complete blocks are restored, and an incomplete last block is removed.
+ */
+void checkpoint_open(char *path, char *input, int limit, struct method_t *methods)
+{
+    uint32_t header[9] = {NUM_SCHED_METHODS, 0, limit, 0, seed_type, budget_type, (uint64_t) budget & 0xffffffff,
+                          (uint64_t) budget >> 32, strlen(input)};
+    int i;
+    size_t k;
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        header[1] |= methods[i].enabled << i;
+    }
+    header[3] = screen | harmonic << 1 | merge << 2 | fail_fast << 3 | mem << 4 | fail_fast_verify << 5;
+
+    clock_gettime(CLOCK_MONOTONIC, &ckpt_last);
+
+    if (ckpt_resume == 0) {
+        ckpt_file = fopen(path, "wb");
+        if (ckpt_file == NULL) {
+            perror(path);
+            exit(EXIT_FAILURE);
+        }
+        fwrite(CKPT_MAGIC, 1, 8, ckpt_file);
+        fwrite(header, sizeof(uint32_t), 9, ckpt_file);
+        fwrite(input, 1, header[8], ckpt_file);
+        return;
+    }
+
+    ckpt_file = fopen(path, "r+b");
+    if (ckpt_file == NULL) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+
+    char magic[8];
+    uint32_t saved[9];
+    char saved_input[header[8] + 1];
+    if (fread(magic, 8, 1, ckpt_file) != 1 || memcmp(magic, CKPT_MAGIC, 8) != 0 ||
+        fread(saved, sizeof(uint32_t), 9, ckpt_file) != 9) {
+        fprintf(stderr, "%s: not a checkpoints file.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (memcmp(saved, header, sizeof(header)) != 0 || fread(saved_input, 1, header[8], ckpt_file) != header[8] ||
+        memcmp(saved_input, input, header[8]) != 0) {
+        fprintf(stderr, "%s: the checkpoints are not of %s with the same methods, limit and options "
+                "(-s, -S, -H, -q, -F, -V, -B and -M).\n", path, input);
+        exit(EXIT_FAILURE);
+    }
+
+    // read the blocks, up to the last complete one
+    long end = ftell(ckpt_file);
+    char block[12];
+    char *counters = NULL;
+    size_t counters_size = 0;
+    for (k = 0; k < NUM_CKPT_VARS; k++) {
+        counters_size += ckpt_vars[k].size;
+    }
+    counters_size += sizeof(long) * 2 * NUM_SCHED_METHODS;
+    counters = malloc(counters_size);
+
+    while (fread(block, 1, 12, ckpt_file) == 12 && memcmp(block, CKPT_BLOCK_MAGIC, 4) == 0) {
+        uint32_t first = *(uint32_t*) (block + 4);
+        uint32_t rows = *(uint32_t*) (block + 8);
+        if (first != (uint32_t) ckpt_resumed) {
+            break;
+        }
+
+        if (ckpt_resumed + rows > (uint32_t) ckpt_size) {
+            ckpt_size = ckpt_resumed + rows;
+            ckpt_rows = realloc(ckpt_rows, CKPT_ROW_SIZE * ckpt_size);
+        }
+        char end_magic[4];
+        if (fread(ckpt_rows + CKPT_ROW_SIZE * ckpt_resumed, CKPT_ROW_SIZE, rows, ckpt_file) != rows ||
+            fread(counters, 1, counters_size, ckpt_file) != counters_size ||
+            fread(end_magic, 1, 4, ckpt_file) != 4 || memcmp(end_magic, CKPT_END_MAGIC, 4) != 0) {
+            break;
+        }
+
+        // counters of the last complete block
+        char *p = counters;
+        for (k = 0; k < NUM_CKPT_VARS; k++) {
+            memcpy(ckpt_vars[k].p, p, ckpt_vars[k].size);
+            p += ckpt_vars[k].size;
+        }
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            memcpy(&methods[i].result->stack_max, p, sizeof(long));
+            memcpy(&methods[i].result->heap_max, p + sizeof(long), sizeof(long));
+            p += sizeof(long) * 2;
+        }
+
+        ckpt_resumed += rows;
+        end = ftell(ckpt_file);
+    }
+    free(counters);
+
+    if (fseek(ckpt_file, end, SEEK_SET) != 0 || ftruncate(fileno(ckpt_file), end) != 0) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    ckpt_first = ckpt_resumed;
+}
+
+/*
+ * Copy the results of the rts saved in the checkpoints.
+ */
+void checkpoint_restore(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int i;
+
+    char *row = ckpt_rows + CKPT_ROW_SIZE * idx;
+    int32_t *sched = (int32_t*) row;
+    double *values = (double*) (row + sizeof(int32_t) * (NUM_SCHED_METHODS + 2));
+
+    settled[idx] = sched[NUM_SCHED_METHODS];
+    cached[idx] = sched[NUM_SCHED_METHODS + 1];
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        rts->schedulable[i] = sched[i];
+        methods[i].result->cc[idx] = values[4 * i];
+        methods[i].result->loops[idx] = values[4 * i + 1];
+        methods[i].result->nsecs[idx] = values[4 * i + 2];
+        methods[i].result->stack[idx] = values[4 * i + 3];
+    }
+
+    // the aggregates of the rts are computed again
+    if (buckets_file != NULL) {
+        bucket_add(rts, methods, idx);
+    }
+    if (sketch_path != NULL) {
+        sketch_rts(methods, idx);
+    }
+}
+
+/*
+ * Add the results of the rts to the next block, and write it if ckpt_secs
+ * elapsed since the last checkpoint.
+ */
+void checkpoint_add(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int i;
+
+    int row_idx = idx - ckpt_first;
+    if (row_idx >= ckpt_size) {
+        ckpt_size = ckpt_size == 0 ? 1024 : 2 * ckpt_size;
+        ckpt_rows = realloc(ckpt_rows, CKPT_ROW_SIZE * ckpt_size);
+    }
+
+    char *row = ckpt_rows + CKPT_ROW_SIZE * row_idx;
+    int32_t *sched = (int32_t*) row;
+    double *values = (double*) (row + sizeof(int32_t) * (NUM_SCHED_METHODS + 2));
+
+    sched[NUM_SCHED_METHODS] = settled[idx];
+    sched[NUM_SCHED_METHODS + 1] = cached[idx];
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        sched[i] = rts->schedulable[i];
+        values[4 * i] = methods[i].result->cc[idx];
+        values[4 * i + 1] = methods[i].result->loops[idx];
+        values[4 * i + 2] = methods[i].result->nsecs[idx];
+        values[4 * i + 3] = methods[i].result->stack[idx];
+    }
+    ckpt_len = row_idx + 1;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    if (now.tv_sec - ckpt_last.tv_sec >= ckpt_secs) {
+        checkpoint_write(methods);
+        ckpt_last = now;
+    }
+}
+
+/*
+ * Append a block with the results of the rts added since the last
+ * checkpoint, and the counters.
+ */
+void checkpoint_write(struct method_t *methods)
+{
+    uint32_t block[2] = {ckpt_first, ckpt_len};
+    size_t k;
+    int i;
+
+    fwrite(CKPT_BLOCK_MAGIC, 1, 4, ckpt_file);
+    fwrite(block, sizeof(uint32_t), 2, ckpt_file);
+    fwrite(ckpt_rows, CKPT_ROW_SIZE, ckpt_len, ckpt_file);
+    for (k = 0; k < NUM_CKPT_VARS; k++) {
+        fwrite(ckpt_vars[k].p, 1, ckpt_vars[k].size, ckpt_file);
+    }
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        fwrite(&methods[i].result->stack_max, sizeof(long), 1, ckpt_file);
+        fwrite(&methods[i].result->heap_max, sizeof(long), 1, ckpt_file);
+    }
+    fwrite(CKPT_END_MAGIC, 1, 4, ckpt_file);
+
+    if (fflush(ckpt_file) != 0 || fsync(fileno(ckpt_file)) != 0) {
+        perror("checkpoint");
+        exit(EXIT_FAILURE);
+    }
+
+    ckpt_first += ckpt_len;
+    ckpt_len = 0;
+}
+
+/*
+ * Secs from the start of the run to now.
+ */
+double telemetry_elapsed(struct timespec *now)
+{
+    return (now->tv_sec - telemetry_start.tv_sec) + (now->tv_nsec - telemetry_start.tv_nsec) / 1e9;
+}
+
+/*
+ * Add the results of the rts to the cumulative cost, and write a telemetry
+ * line if telemetry_secs elapsed since the last one (or if done).
+ */
+void telemetry_rts(struct method_t *methods, int idx, int done)
+{
+    int i;
+
+    if (done == 0) {
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            telemetry_cost[i][BUCKET_CC] += methods[i].result->cc[idx];
+            telemetry_cost[i][BUCKET_LOOPS] += methods[i].result->loops[idx];
+            if ((cached[idx] >> methods[i].method_id & 1) == 0) {
+                telemetry_cost[i][BUCKET_NSECS] += methods[i].result->nsecs[idx];
+            }
+        }
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (done == 0 && now.tv_sec - telemetry_last.tv_sec < telemetry_secs) {
+        return;
+    }
+    telemetry_last = now;
+
+    // the rts restored from the checkpoints are left out of the rate and the cost
+    int rts = (done ? rts_founded : idx + 1) - ckpt_resumed;
+    if (rts < 0) {
+        rts = 0;
+    }
+    int left = telemetry_limit - ckpt_resumed - rts;
+    double elapsed = telemetry_elapsed(&now);
+    double rate = elapsed > 0 ? rts / elapsed : 0.0;
+    double eta = done == 0 && rate > 0 && left > 0 ? left / rate : 0.0;
+
+    fprintf(telemetry_file, "{\"event\": \"%s\", \"elapsed\": %.3f, \"rts\": %d, \"resumed\": %d, \"limit\": %d, "
+                            "\"rts_per_sec\": %.3f, \"eta\": %.3f, \"cache_hits\": %ld, \"methods\": {",
+            done ? "done" : "progress", elapsed, rts, ckpt_resumed, telemetry_limit, rate, eta, cache_hits);
+    int first = 1;
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        fprintf(telemetry_file, "%s\"%s\": {\"cc\": %.0f, \"loops\": %.0f, \"nsecs\": %.0f}", first ? "" : ", ",
+                methods[i].method_name, telemetry_cost[i][BUCKET_CC], telemetry_cost[i][BUCKET_LOOPS],
+                telemetry_cost[i][BUCKET_NSECS]);
+        first = 0;
+    }
+    fprintf(telemetry_file, "}}\n");
+    fflush(telemetry_file);
+}
+
+/*
+ * Count a batch of requests in --serve mode, and write a telemetry line if
+ * telemetry_secs elapsed since the last one. Lines are only written after
+ * a batch, so an idle service writes nothing.
+ */
+void telemetry_batch(int num_reqs, int num_clients, int num_sets)
+{
+    telemetry_reqs += num_reqs;
+    telemetry_batches += 1;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (now.tv_sec - telemetry_last.tv_sec < telemetry_secs) {
+        return;
+    }
+    telemetry_last = now;
+
+    double elapsed = telemetry_elapsed(&now);
+    fprintf(telemetry_file, "{\"event\": \"serve\", \"elapsed\": %.3f, \"requests\": %ld, \"requests_per_sec\": %.3f, "
+                            "\"batches\": %ld, \"batch\": %d, \"clients\": %d, \"sets\": %d}\n",
+            elapsed, telemetry_reqs, elapsed > 0 ? telemetry_reqs / elapsed : 0.0, telemetry_batches, num_reqs,
+            num_clients, num_sets);
+    fflush(telemetry_file);
+}
+
+const char *col_rts_names[] = {"run", "rts_id", "uf", "ntask", "method_id", "sched", "cc", "loops", "nsecs"};
+const char *col_task_names[] = {"run", "rts_id", "method_id", "task", "wcrt", "cc", "loops_w", "loops_f"};
+
+struct col_table col_tables[NUM_COL_TABLES] = {
+    {sizeof(col_rts_names) / sizeof(char*), col_rts_names, 0, NULL},
+    {sizeof(col_task_names) / sizeof(char*), col_task_names, 0, NULL}
+};
+
+/*
+ * Name of the method in the results files and stores. The het of the sim is
+ * the het2 of the board (see store_method_ids), so both are reported together.
+ */
+const char *col_method_name(struct method_t *method)
+{
+    return method->method_id == HET_ID ? "het2" : method->method_name;
+}
+
+/*
+ * v with its bytes in little endian order, the byte order of the results file.
+ */
+uint32_t col_le32(uint32_t v)
+{
+    unsigned char b[4];
+    int i;
+    for (i = 0; i < 4; i++) {
+        b[i] = (v >> (8 * i)) & 0xff;
+    }
+    memcpy(&v, b, 4);
+    return v;
+}
+
+uint64_t col_le64(uint64_t v)
+{
+    unsigned char b[8];
+    int i;
+    for (i = 0; i < 8; i++) {
+        b[i] = (v >> (8 * i)) & 0xff;
+    }
+    memcpy(&v, b, 8);
+    return v;
+}
+
+/*
+ * Open the columnar results file. If the file already has results, check
+ * that they are from the same methods, and append the new rows.
+ */
+void col_open(char *path, struct method_t *methods)
+{
+    char header[8 + sizeof(uint32_t) + 8 * NUM_SCHED_METHODS];
+    char old_header[sizeof(header)];
+    uint32_t num_methods = col_le32(NUM_SCHED_METHODS);
+    int i;
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, COL_MAGIC, 8);
+    memcpy(header + 8, &num_methods, sizeof(uint32_t));
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        strncpy(header + 12 + 8 * i, col_method_name(&methods[i]), 7);
+    }
+
+    FILE *f = fopen(path, "rb");
+    size_t len = 0;
+    if (f != NULL) {
+        len = fread(old_header, 1, sizeof(old_header), f);
+        fclose(f);
+        if (len > 0 && (len != sizeof(header) || memcmp(header, old_header, sizeof(header)) != 0)) {
+            fprintf(stderr, "%s: not a results file of this version.\n", path);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    col_file = fopen(path, "ab");
+    if (col_file == NULL) {
+        perror(path);
+        exit(EXIT_FAILURE);
+    }
+    if (len == 0) {
+        fwrite(header, 1, sizeof(header), col_file);
+    }
+
+    for (i = 0; i < NUM_COL_TABLES; i++) {
+        col_tables[i].data = malloc(sizeof(int64_t) * col_tables[i].ncols * COL_CHUNK_ROWS);
+        col_tables[i].nrows = 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    col_run = (int64_t) now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/*
+ * Add a row to the table, writing a chunk when full.
+ */
+void col_add(int table, int64_t *row)
+{
+    struct col_table *t = &col_tables[table];
+    int k;
+
+    for (k = 0; k < t->ncols; k++) {
+        t->data[k * COL_CHUNK_ROWS + t->nrows] = col_le64(row[k]);
+    }
+    t->nrows += 1;
+
+    if (t->nrows == COL_CHUNK_ROWS) {
+        col_flush(table);
+    }
+}
+
+/*
+ * Write the rows of the table as a chunk.
+ */
+void col_flush(int table)
+{
+    struct col_table *t = &col_tables[table];
+    uint32_t chunk[3] = {col_le32(table), col_le32(t->nrows), col_le32(t->ncols)};
+    int k;
+
+    if (t->nrows == 0) {
+        return;
+    }
+
+    uLong raw_len = sizeof(int64_t) * t->nrows;
+    uLong max_len = compressBound(raw_len);
+    Bytef *buf = malloc(max_len);
+
+    fwrite(COL_CHUNK_MAGIC, 1, 4, col_file);
+    fwrite(chunk, sizeof(uint32_t), 3, col_file);
+
+    for (k = 0; k < t->ncols; k++) {
+        char name[COL_NAME_LEN];
+        memset(name, 0, COL_NAME_LEN);
+        strncpy(name, t->names[k], COL_NAME_LEN - 1);
+
+        const Bytef *values = (const Bytef*) &t->data[k * COL_CHUNK_ROWS];
+        uLong stored_len = max_len;
+        if (col_level == 0 || compress2(buf, &stored_len, values, raw_len, col_level) != Z_OK || stored_len >= raw_len) {
+            stored_len = raw_len;
+        }
+
+        uint32_t sizes[2] = {col_le32(raw_len), col_le32(stored_len)};
+        fwrite(name, 1, COL_NAME_LEN, col_file);
+        fwrite(sizes, sizeof(uint32_t), 2, col_file);
+        fwrite(stored_len < raw_len ? buf : values, 1, stored_len, col_file);
+    }
+
+    free(buf);
+    t->nrows = 0;
+}
+
+/*
+ * Add the results of the enabled methods with the rts to the results file.
+ */
+void col_rts_rows(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int i, k;
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int m = methods[i].method_id;
+        struct result_t *result = methods[i].result;
+
+        int64_t row[] = {col_run, rts->rts_id, rts->rts_uf, rts->rts_ntask, m, rts->schedulable[m],
+                         (int64_t) result->cc[idx], (int64_t) result->loops[idx], (int64_t) result->nsecs[idx]};
+        col_add(COL_RTS, row);
+
+        if (col_detail == 0) {
+            continue;
+        }
+        for (k = 0; k < rts->rts_ntask; k++) {
+            struct task_t *task = rts->tasks[k];
+            int64_t task_row[] = {col_run, rts->rts_id, m, k + 1, task->wcrt[m], task->cc[m], task->loops_w[m], task->loops_f[m]};
+            col_add(COL_TASK, task_row);
+        }
+    }
+}
+
+#ifdef USE_HDF5
+const char *store_col_names[STORE_NUM_COLS] = {"method_id", "sched", "usecs", "cycles", "cc", "loops", "uf", "rts_size", "rts_id"};
+
+// method ids of wcrt-test-mbed.py (supported_methods in main-config-tmpl.json), named in wcrt_results.py
+const int store_method_ids[NUM_SCHED_METHODS] = {[HET_ID] = 1, [RTA_ID] = 2, [RTA2_ID] = 3, [RTA3_ID] = 4, [RTA4_ID] = 5,
+                                                 [HETI_ID] = 6, [AUTO_ID] = 7, [RTA4A_ID] = 8};
+
+struct store_t *store = NULL;
+
+/*
+ * Write a string attribute, as PyTables does (fixed length, without the '\0').
+ */
+void store_attr_str(hid_t obj, const char *name, const char *value)
+{
+    size_t len = strlen(value);
+    hid_t type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, len > 0 ? len : 1);
+    hid_t space = H5Screate(len > 0 ? H5S_SCALAR : H5S_NULL);
+
+    if (H5Aexists(obj, name) > 0) {
+        H5Adelete(obj, name);
+    }
+    hid_t attr = H5Acreate2(obj, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+    if (len > 0) {
+        H5Awrite(attr, type, value);
+    }
+
+    H5Aclose(attr);
+    H5Sclose(space);
+    H5Tclose(type);
+}
+
+void store_attr_int(hid_t obj, const char *name, int64_t value)
+{
+    hid_t space = H5Screate(H5S_SCALAR);
+
+    if (H5Aexists(obj, name) > 0) {
+        H5Adelete(obj, name);
+    }
+    hid_t attr = H5Acreate2(obj, name, H5T_STD_I64LE, space, H5P_DEFAULT, H5P_DEFAULT);
+    H5Awrite(attr, H5T_NATIVE_INT64, &value);
+
+    H5Aclose(attr);
+    H5Sclose(space);
+}
+
+/*
+ * Append the printf formatted text to the pickle in *buf, of *size bytes,
+ * growing it as needed.
+ */
+void store_pickle_add(char **buf, size_t *size, const char *fmt, ...)
+{
+    size_t len = strlen(*buf);
+    va_list ap;
+
+    va_start(ap, fmt);
+    size_t n = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+
+    if (len + n + 1 > *size) {
+        while (len + n + 1 > *size) {
+            *size *= 2;
+        }
+        *buf = realloc(*buf, *size);
+    }
+
+    va_start(ap, fmt);
+    vsnprintf(*buf + len, *size - len, fmt, ap);
+    va_end(ap);
+}
+
+/*
+ * Append a string to the pickle in *buf, in the raw-unicode-escape encoding
+ * of the 'V' opcode of the pickle protocol 0.
+ */
+void store_pickle_str(char **buf, size_t *size, const char *str)
+{
+    store_pickle_add(buf, size, "V");
+    for (; *str != '\0'; str++) {
+        if (*str == '\\' || *str == '\n') {
+            store_pickle_add(buf, size, "\\u%04x", *str);
+        } else {
+            store_pickle_add(buf, size, "%c", *str);
+        }
+    }
+    store_pickle_add(buf, size, "\n");
+}
+
+/*
+ * Open (or create) the store, and create the results table under key,
+ * replacing the previous one, as wcrt-test-mbed.py does. The attributes of
+ * the group and the table are the ones written by pandas for a table with a
+ * single int64 values block, so the store can be read with pd.read_hdf.
+ */
+void store_open(char *path, char *key, char *input, int limit, struct method_t *methods)
+{
+    size_t size = 1024;
+    char *pickle = malloc(size);
+    char str[1024];
+    int i;
+
+    H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+    store = malloc(sizeof(struct store_t));
+    store->nrows = 0;
+    store->len = 0;
+
+    store->file = access(path, F_OK) == 0 ? H5Fopen(path, H5F_ACC_RDWR, H5P_DEFAULT) :
+                                           H5Fcreate(path, H5F_ACC_EXCL, H5P_DEFAULT, H5P_DEFAULT);
+    if (store->file < 0) {
+        fprintf(stderr, "Unable to open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    hid_t root = H5Gopen2(store->file, "/", H5P_DEFAULT);
+    store_attr_str(root, "CLASS", "GROUP");
+    store_attr_str(root, "PYTABLES_FORMAT_VERSION", "2.1");
+    store_attr_str(root, "TITLE", "");
+    store_attr_str(root, "VERSION", "1.0");
+    H5Gclose(root);
+
+    if (H5Lexists(store->file, key, H5P_DEFAULT) > 0) {
+        H5Ldelete(store->file, key, H5P_DEFAULT);
+    }
+
+    hid_t lcpl = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(lcpl, 1);
+    store->group = H5Gcreate2(store->file, key, lcpl, H5P_DEFAULT, H5P_DEFAULT);
+    H5Pclose(lcpl);
+    if (store->group < 0) {
+        fprintf(stderr, "%s: unable to create %s\n", path, key);
+        exit(EXIT_FAILURE);
+    }
+
+    // rows of index and values_block_0, in chunks
+    hsize_t dims = STORE_NUM_COLS;
+    hid_t block_type = H5Tarray_create2(H5T_STD_I64LE, 1, &dims);
+    store->row_type = H5Tcreate(H5T_COMPOUND, sizeof(int64_t) * (STORE_NUM_COLS + 1));
+    H5Tinsert(store->row_type, "index", 0, H5T_STD_I64LE);
+    H5Tinsert(store->row_type, "values_block_0", sizeof(int64_t), block_type);
+    H5Tclose(block_type);
+
+    hsize_t zero = 0;
+    hsize_t unlimited = H5S_UNLIMITED;
+    hsize_t chunk = STORE_CHUNK_ROWS;
+    hid_t space = H5Screate_simple(1, &zero, &unlimited);
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(dcpl, 1, &chunk);
+    H5Pset_deflate(dcpl, STORE_DEFLATE);
+    store->table = H5Dcreate2(store->group, "table", store->row_type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+    H5Pclose(dcpl);
+    H5Sclose(space);
+
+    // table attributes
+    store_attr_str(store->table, "CLASS", "TABLE");
+    store_attr_str(store->table, "VERSION", "2.7");
+    store_attr_str(store->table, "TITLE", "");
+    store_attr_str(store->table, "FIELD_0_NAME", "index");
+    store_attr_int(store->table, "FIELD_0_FILL", 0);
+    store_attr_str(store->table, "FIELD_1_NAME", "values_block_0");
+    store_attr_int(store->table, "FIELD_1_FILL", 0);
+    store_attr_int(store->table, "NROWS", 0);
+    store_attr_str(store->table, "index_kind", "integer");
+    store_attr_str(store->table, "values_block_0_dtype", "int64");
+    store_attr_str(store->table, "values_block_0_meta", "N.");
+
+    pickle[0] = '\0';
+    store_pickle_add(&pickle, &size, "(lp0\n");
+    for (i = 0; i < STORE_NUM_COLS; i++) {
+        store_pickle_str(&pickle, &size, store_col_names[i]);
+        store_pickle_add(&pickle, &size, "p%d\na", i + 1);
+    }
+    store_pickle_add(&pickle, &size, ".");
+    store_attr_str(store->table, "values_block_0_kind", pickle);
+
+    // group attributes
+    store_attr_str(store->group, "CLASS", "GROUP");
+    store_attr_str(store->group, "TITLE", "");
+    store_attr_str(store->group, "VERSION", "1.0");
+    store_attr_str(store->group, "data_columns", "(lp0\n.");
+    store_attr_str(store->group, "encoding", "UTF-8");
+    store_attr_str(store->group, "errors", "strict");
+    store_attr_str(store->group, "index_cols", "(lp0\n(I0\nVindex\np1\ntp2\na.");
+    store_attr_str(store->group, "info", "(dp0\nI1\n(dp1\nVnames\np2\n(lp3\nNasVtype\np4\nVIndex\np5\nssVindex\np6\n"
+                                         "(dp7\nsVvalues_block_0\np8\n(dp9\ns.");
+    store_attr_int(store->group, "levels", 1);
+    store_attr_str(store->group, "nan_rep", "nan");
+    store_attr_str(store->group, "pandas_type", "frame_table");
+    store_attr_str(store->group, "pandas_version", "0.15.2");
+    store_attr_str(store->group, "table_type", "appendable_frame");
+    store_attr_str(store->group, "values_cols", "(lp0\nVvalues_block_0\np1\na.");
+
+    pickle[0] = '\0';
+    store_pickle_add(&pickle, &size, "(lp0\n(I1\n(lp1\n");
+    for (i = 0; i < STORE_NUM_COLS; i++) {
+        store_pickle_str(&pickle, &size, store_col_names[i]);
+        store_pickle_add(&pickle, &size, "p%d\na", i + 2);
+    }
+    store_pickle_add(&pickle, &size, "tp%d\na.", STORE_NUM_COLS + 2);
+    store_attr_str(store->group, "non_index_axes", pickle);
+
+    // metadata, as the one of wcrt-test-mbed.py
+    time_t now = time(NULL);
+    strftime(str, sizeof(str), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    pickle[0] = '\0';
+    store_pickle_add(&pickle, &size, "(d");
+    store_pickle_str(&pickle, &size, "datetime");
+    store_pickle_str(&pickle, &size, str);
+    store_pickle_add(&pickle, &size, "s");
+    store_pickle_str(&pickle, &size, "board_info");
+    store_pickle_add(&pickle, &size, "(d");
+    store_pickle_str(&pickle, &size, "platform_name");
+    store_pickle_str(&pickle, &size, "wcrt-test-sim");
+    store_pickle_add(&pickle, &size, "s");
+    store_pickle_str(&pickle, &size, "cycles");
+    store_pickle_str(&pickle, &size, "nsecs");
+    store_pickle_add(&pickle, &size, "ss");
+    store_pickle_str(&pickle, &size, "config");
+    store_pickle_add(&pickle, &size, "(d");
+    store_pickle_str(&pickle, &size, "file");
+    store_pickle_str(&pickle, &size, input);
+    store_pickle_add(&pickle, &size, "s");
+    store_pickle_str(&pickle, &size, "limit");
+    store_pickle_add(&pickle, &size, "I%d\ns", limit);
+    store_pickle_str(&pickle, &size, "methods");
+    store_pickle_add(&pickle, &size, "(l");
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 1) {
+            store_pickle_str(&pickle, &size, col_method_name(&methods[i]));
+            store_pickle_add(&pickle, &size, "a");
+        }
+    }
+    store_pickle_add(&pickle, &size, "ss.");
+    store_attr_str(store->group, "metadata", pickle);
+
+    free(pickle);
+}
+
+/*
+ * Append the rows in the buffer to the table.
+ */
+void store_flush()
+{
+    if (store->len == 0) {
+        return;
+    }
+
+    hsize_t count = store->len;
+    hsize_t size = store->nrows + count;
+    H5Dset_extent(store->table, &size);
+
+    hid_t space = H5Dget_space(store->table);
+    hid_t mem_space = H5Screate_simple(1, &count, NULL);
+    H5Sselect_hyperslab(space, H5S_SELECT_SET, &store->nrows, NULL, &count, NULL);
+    H5Dwrite(store->table, store->row_type, mem_space, space, H5P_DEFAULT, store->buf);
+    H5Sclose(mem_space);
+    H5Sclose(space);
+
+    store->nrows = size;
+    store->len = 0;
+}
+
+/*
+ * Add the results of the enabled methods with the rts to the store.
+ */
+void store_rts_rows(struct rts_t *rts, struct method_t *methods, int idx)
+{
+    int i;
+
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
+        int m = methods[i].method_id;
+        struct result_t *result = methods[i].result;
+        int64_t *row = store->buf[store->len];
+
+        row[0] = store->nrows + store->len;
+        row[1] = store_method_ids[m];
+        row[2] = rts->schedulable[m];
+        row[3] = (int64_t) (result->nsecs[idx] / 1000.0 + 0.5);
+        row[4] = (int64_t) result->nsecs[idx];
+        row[5] = (int64_t) result->cc[idx];
+        row[6] = (int64_t) result->loops[idx];
+        row[7] = rts->rts_uf;
+        row[8] = rts->rts_ntask;
+        row[9] = rts->rts_id;
+
+        store->len += 1;
+        if (store->len == STORE_CHUNK_ROWS) {
+            store_flush();
+        }
+    }
+}
+
+void store_close()
+{
+    store_flush();
+    store_attr_int(store->table, "NROWS", store->nrows);
+
+    H5Tclose(store->row_type);
+    H5Dclose(store->table);
+    H5Gclose(store->group);
+    H5Fclose(store->file);
+    free(store);
+}
+#endif
+
+/*
+ * Print method results to out_file.
+ */
+void save_result(char* method, struct result_t* result, int use_csv, char *csv_sep)
+{
+    if (use_csv == 0) {
+        fprintf(out_file, "%10s%15f%15f%15f%15f\n", method, result->cc_mean, result->cc_std, 
+                                                    result->loops_mean, result->loops_std);
+    } else {
+        fprintf(out_file, "%2$s%1$s%3$f%1$s%4$f%1$s%5$f%1$s%6$f\n", csv_sep, method, result->cc_mean, result->cc_std, 
+                                                                                     result->loops_mean, result->loops_std);
+    }    
+}
+
+/*
+ * Evaluate the n tasks with parameters c, t and d, in priority order, with
+ * the method method_id. The wcrt of each task is stored in wcrt (0 after a
+ * task misses its deadline), and the ceil operations and while and for loops
+ * in cc, loops_w and loops_f, if not NULL. Returns SCHED or NON_SCHED. Can be
+ * called from several threads at the same time.
+ */
+int analyse_tasks(int n, const int *c, const int *t, const int *d, int method_id, int *wcrt, int *cc, int *loops_w, int *loops_f)
+{
+    struct rts_t rts;
+    int schedulable[NUM_SCHED_METHODS];
+    struct task_t *task_list = malloc(sizeof(struct task_t) * n);
+    struct task_t **tasks = malloc(sizeof(struct task_t*) * n);
+
+    int i;
+    for (i = 0; i < n; i++) {
+        tasks[i] = &task_list[i];
+        tasks[i]->id = i + 1;
+        tasks[i]->c = c[i];
+        tasks[i]->t = t[i];
+        tasks[i]->d = d[i];
+        tasks[i]->tmc = t[i] - c[i];
+    }
+
+    rts.rts_id = 0;
+    rts.rts_uf = 0;
+    rts.rts_ntask = n;
+    rts.schedulable = schedulable;
+    rts.tasks = tasks;
+    rts.harmonic = 0;
+    rts.chains = 0;
+    rts.auto_method = 0;
+    rts.trace = 0;
+    rts.attribution = 0;
+
+    reset_tasks(&rts);
+    int sched = (*method_funcs[method_id])(&rts);
+
+    for (i = 0; i < n; i++) {
+        wcrt[i] = tasks[i]->wcrt[method_id];
+        if (cc != NULL) {
+            cc[i] = tasks[i]->cc[method_id];
+        }
+        if (loops_w != NULL) {
+            loops_w[i] = tasks[i]->loops_w[method_id];
+        }
+        if (loops_f != NULL) {
+            loops_f[i] = tasks[i]->loops_f[method_id];
+        }
+    }
+
+    free(tasks);
+    free(task_list);
+
+    return sched;
+}
+
+/*
+ * Task set with the given name, or NULL if it does not exist and create is 0.
+ */
+struct named_set *serve_find(struct named_set **sets, int *num_sets, char *name, int create)
+{
+    int i;
+    for (i = 0; i < *num_sets; i++) {
+        if (strcmp((*sets)[i].name, name) == 0) {
+            return &(*sets)[i];
+        }
+    }
+
+    if (create == 0) {
+        return NULL;
+    }
+
+    *sets = realloc(*sets, sizeof(struct named_set) * (*num_sets + 1));
+    struct named_set *set = &(*sets)[*num_sets];
+    *num_sets += 1;
+
+    strcpy(set->name, name);
+    set->n = 0;
+    set->size = 0;
+    set->next_id = 1;
+    set->id = NULL;
+    set->c = NULL;
+    set->t = NULL;
+    set->d = NULL;
+
+    return set;
+}
+
+/*
+ * Position of a task with deadline d and period t in the set, in DM order.
+ */
+int serve_position(struct named_set *set, int t, int d)
+{
+    int k = set->n;
+    while (k > 0 && (set->d[k - 1] > d || (set->d[k - 1] == d && set->t[k - 1] > t))) {
+        k -= 1;
+    }
+    return k;
+}
+
+/*
+ * Apply an ADD or REMOVE request to the task sets.
+ */
+void serve_update(struct serve_req *req, struct named_set **sets, int *num_sets)
+{
+    int k;
+
+    if (req->op == SERVE_ADD) {
+        int c = req->arg[0];
+        int t = req->arg[1];
+        int d = req->arg[2];
+        if (c <= 0 || c >= t || d < c || d > t) {
+            req->status = SERVE_EINVAL;
+            return;
+        }
+
+        struct named_set *set = serve_find(sets, num_sets, req->name, 1);
+        if (set->n == set->size) {
+            set->size = set->size > 0 ? set->size * 2 : 16;
+            set->id = realloc(set->id, sizeof(int) * set->size);
+            set->c = realloc(set->c, sizeof(int) * set->size);
+            set->t = realloc(set->t, sizeof(int) * set->size);
+            set->d = realloc(set->d, sizeof(int) * set->size);
+        }
+
+        int pos = serve_position(set, t, d);
+        for (k = set->n; k > pos; k--) {
+            set->id[k] = set->id[k - 1];
+            set->c[k] = set->c[k - 1];
+            set->t[k] = set->t[k - 1];
+            set->d[k] = set->d[k - 1];
+        }
+        set->id[pos] = set->next_id;
+        set->c[pos] = c;
+        set->t[pos] = t;
+        set->d[pos] = d;
+        set->n += 1;
+        set->next_id += 1;
+
+        req->status = SERVE_OK;
+        req->n = set->id[pos];
+        return;
+    }
+
+    struct named_set *set = serve_find(sets, num_sets, req->name, 0);
+    if (set == NULL) {
+        req->status = SERVE_ENOSET;
+        return;
+    }
+
+    for (k = 0; k < set->n; k++) {
+        if (set->id[k] == req->arg[0]) {
+            break;
+        }
+    }
+    if (k == set->n) {
+        req->status = SERVE_ENOTASK;
+        return;
+    }
+
+    for (; k < set->n - 1; k++) {
+        set->id[k] = set->id[k + 1];
+        set->c[k] = set->c[k + 1];
+        set->t[k] = set->t[k + 1];
+        set->d[k] = set->d[k + 1];
+    }
+    set->n -= 1;
+
+    req->status = SERVE_OK;
+    req->n = set->n;
+}
+
+/*
+ * Evaluate a QUERY request. The set is not changed, so many queries can be
+ * evaluated at the same time.
+ */
+void serve_query(struct serve_req *req, struct named_set *set)
+{
+    int method_id = req->arg[0];
+    int c = req->arg[1];
+    int t = req->arg[2];
+    int d = req->arg[3];
+
+    req->n = 0;
+    req->wcrt = NULL;
+
+    if (set == NULL) {
+        req->status = SERVE_ENOSET;
+        return;
+    }
+    if (method_id < 0 || method_id >= NUM_SCHED_METHODS || method_id == AUTO_ID || method_id == RTA4A_ID ||
+        (c > 0 && (c >= t || d < c || d > t))) {
+        req->status = SERVE_EINVAL;
+        return;
+    }
+
+    // the methods other than rta assume D = T
+    int constrained = c > 0 && d < t;
+    int i, k = 0;
+    for (i = 0; i < set->n; i++) {
+        constrained |= set->d[i] < set->t[i];
+    }
+    if (constrained && method_id != RTA_ID) {
+        req->status = SERVE_EINVAL;
+        return;
+    }
+
+    // task set with the new task in its DM position
+    int n = set->n + (c > 0 ? 1 : 0);
+    int pos = c > 0 ? serve_position(set, t, d) : set->n;
+    int *tc = malloc(sizeof(int) * n);
+    int *tt = malloc(sizeof(int) * n);
+    int *td = malloc(sizeof(int) * n);
+
+    for (i = 0; i < n; i++) {
+        if (c > 0 && i == pos) {
+            tc[i] = c;
+            tt[i] = t;
+            td[i] = d;
+        } else {
+            tc[i] = set->c[k];
+            tt[i] = set->t[k];
+            td[i] = set->d[k];
+            k += 1;
+        }
+    }
+
+    int *cc = malloc(sizeof(int) * (n > 0 ? n : 1));
+    req->wcrt = malloc(sizeof(int) * (n > 0 ? n : 1));
+    req->n = n;
+    req->sched = n > 0 ? analyse_tasks(n, tc, tt, td, method_id, req->wcrt, cc, NULL, NULL) : SCHED;
+    req->cc = 0;
+    for (i = 0; i < n; i++) {
+        req->cc += cc[i];
+    }
+    req->status = SERVE_OK;
+
+    free(cc);
+    free(tc);
+    free(tt);
+    free(td);
+}
+
+/*
+ * Parse one request from buf. Returns the number of bytes used, 0 if the
+ * request is not complete, or -1 if it is not valid.
+ */
+int serve_parse(char *buf, int len, struct serve_req *req)
+{
+    uint32_t v[6];
+
+    if (len < 8) {
+        return 0;
+    }
+    memcpy(v, buf, 8);
+    req->op = ntohl(v[0]);
+    int name_len = ntohl(v[1]);
+    if (name_len < 0 || name_len >= SERVE_NAME_LEN) {
+        return -1;
+    }
+
+    int nargs;
+    switch (req->op) {
+        case SERVE_ADD:
+            nargs = 3;
+            break;
+        case SERVE_REMOVE:
+            nargs = 1;
+            break;
+        case SERVE_QUERY:
+            nargs = 4;
+            break;
+        default:
+            return -1;
+    }
+
+    int size = 8 + name_len + 4 * nargs;
+    if (len < size) {
+        return 0;
+    }
+
+    memcpy(req->name, buf + 8, name_len);
+    req->name[name_len] = '\0';
+    memcpy(v, buf + 8 + name_len, 4 * nargs);
+
+    int i;
+    for (i = 0; i < nargs; i++) {
+        req->arg[i] = ntohl(v[i]);
+    }
+
+    req->status = SERVE_EINVAL;
+    req->sched = 0;
+    req->cc = 0;
+    req->n = 0;
+    req->wcrt = NULL;
+
+    return size;
+}
+
+/*
+ * Append the reply of the request to the write buffer of its client.
+ */
+void serve_reply(struct serve_req *req, struct serve_client *client)
+{
+    int len = 0;
+    uint32_t *v = malloc(sizeof(uint32_t) * (4 + req->n));
+
+    v[len++] = htonl(req->status);
+    if (req->op == SERVE_QUERY) {
+        v[len++] = htonl(req->sched);
+        v[len++] = htonl(req->cc);
+        v[len++] = htonl(req->n);
+        int i;
+        for (i = 0; i < req->n; i++) {
+            v[len++] = htonl(req->wcrt[i]);
+        }
+    } else {
+        v[len++] = htonl(req->n);
+    }
 
-                if (tr > tasks[j]->b_rta4) {
-                    int a_dif = tr - tasks[j]->a_rta4;
-                    int a_t = U_CEIL( a_dif, tasks[j]->tmc );
-                    
-                    tasks[i]->cc[RTA4_ID] += 1;
+    int size = sizeof(uint32_t) * len;
+    if (client->out_len + size > client->out_size) {
+        while (client->out_len + size > client->out_size) {
+            client->out_size *= 2;
+        }
+        client->out = realloc(client->out, client->out_size);
+    }
+    memcpy(client->out + client->out_len, v, size);
+    client->out_len += size;
 
-                    tasks[j]->a_rta4 = a_t * tasks[j]->c;
-                    tasks[j]->b_rta4 = a_t * tasks[j]->t;
-                    tr = tasks[j]->a_rta4 + a_dif;
-                    
-                    // verifica vencimiento
-                    if (tr > tasks[i]->d) {
-                        rts->schedulable[RTA4_ID] = NON_SCHED;
-                        return NON_SCHED;
+    free(v);
+    free(req->wcrt);
+    req->wcrt = NULL;
+}
+
+/*
+ * Write as much of the write buffer of the client as its socket accepts,
+ * without blocking. Returns -1 if the client can not be written.
+ */
+int serve_flush(struct serve_client *client)
+{
+    int sent = 0;
+    while (sent < client->out_len) {
+        ssize_t w = write(client->fd, client->out + sent, client->out_len - sent);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (w <= 0) {
+            return -1;
+        }
+        sent += w;
+    }
+
+    memmove(client->out, client->out + sent, client->out_len - sent);
+    client->out_len -= sent;
+    return 0;
+}
+
+/*
+ * Close client i, and drop its pending requests. The last client takes its
+ * place.
+ */
+void serve_close(struct serve_client *clients, int *num_fds, int i, struct serve_req *reqs, int *num_reqs)
+{
+    int j, k;
+    for (j = 0, k = 0; j < *num_reqs; j++) {
+        if (reqs[j].fd != clients[i].fd) {
+            reqs[k++] = reqs[j];
+        }
+    }
+    *num_reqs = k;
+
+    close(clients[i].fd);
+    free(clients[i].in);
+    free(clients[i].out);
+    clients[i] = clients[*num_fds - 1];
+    *num_fds -= 1;
+}
+
+void serve_signal(int sig)
+{
+    serve_stop = 1;
+}
+
+/*
+ * Admission control service. Listen on the Unix socket path, and answer the
+ * requests of the clients. The requests that arrive within serve_batch msecs
+ * of the first one are handled as a batch: ADD and REMOVE are applied in
+ * order, and each run of consecutive QUERY requests is evaluated in parallel.
+ */
+int serve(char *path)
+{
+    struct named_set *sets = NULL;
+    int num_sets = 0;
+
+    struct serve_client clients[SERVE_MAX_CLIENTS + 1];     // clients[0].fd is the socket
+    int num_fds = 1;
+
+    struct serve_req *reqs = NULL;
+    int num_reqs = 0;
+    int size_reqs = 0;
+
+    int i, j, k;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    clients[0].fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(path);
+    if (clients[0].fd < 0 || bind(clients[0].fd, (struct sockaddr*) &addr, sizeof(addr)) < 0 ||
+        listen(clients[0].fd, SERVE_MAX_CLIENTS) < 0) {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT, serve_signal);
+    signal(SIGTERM, serve_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    if (verbose == 1) {
+        fprintf(stderr, "Listening on %s.\n", path);
+    }
+
+    while (serve_stop == 0) {
+        struct pollfd pfds[SERVE_MAX_CLIENTS + 1];
+        int timeout = -1;       // wait for the first request of the batch
+        struct timespec first, now;
+
+        num_reqs = 0;
+
+        for (;;) {
+            for (i = 0; i < num_fds; i++) {
+                pfds[i].fd = clients[i].fd;
+                pfds[i].events = (i == 0 || clients[i].eof == 0) ? POLLIN : 0;
+                if (i > 0 && clients[i].out_len > 0) {
+                    pfds[i].events |= POLLOUT;
+                }
+            }
+
+            int ready = poll(pfds, num_fds, timeout);
+            if (ready < 0 && errno == EINTR) {
+                break;
+            }
+            if (ready <= 0) {
+                break;          // end of the batch window
+            }
+
+            // new clients
+            if (pfds[0].revents & POLLIN) {
+                int fd = accept(clients[0].fd, NULL, NULL);
+                if (fd >= 0 && num_fds <= SERVE_MAX_CLIENTS) {
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                    clients[num_fds].fd = fd;
+                    clients[num_fds].in = malloc(SERVE_BUF_LEN);
+                    clients[num_fds].in_len = 0;
+                    clients[num_fds].out = malloc(SERVE_BUF_LEN);
+                    clients[num_fds].out_len = 0;
+                    clients[num_fds].out_size = SERVE_BUF_LEN;
+                    clients[num_fds].eof = 0;
+                    pfds[num_fds].revents = 0;
+                    num_fds += 1;
+                } else if (fd >= 0) {
+                    close(fd);
+                }
+            }
+
+            for (i = 1; i < num_fds; i++) {
+                struct serve_client *client = &clients[i];
+                int closed = 0;
+
+                // replies of the previous batches
+                if ((pfds[i].revents & (POLLOUT | POLLHUP | POLLERR)) && client->out_len > 0) {
+                    closed = serve_flush(client) < 0;
+                }
+
+                // new requests
+                if (closed == 0 && client->eof == 0 && (pfds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                    ssize_t r = read(client->fd, client->in + client->in_len, SERVE_BUF_LEN - client->in_len);
+                    int used = 0;
+                    if (r > 0) {
+                        client->in_len += r;
+                        for (;;) {
+                            if (num_reqs == size_reqs) {
+                                size_reqs = size_reqs > 0 ? size_reqs * 2 : 64;
+                                reqs = realloc(reqs, sizeof(struct serve_req) * size_reqs);
+                            }
+                            int size = serve_parse(client->in + used, client->in_len - used, &reqs[num_reqs]);
+                            if (size <= 0) {
+                                used = (size < 0) ? -1 : used;
+                                break;
+                            }
+                            reqs[num_reqs].fd = client->fd;
+                            num_reqs += 1;
+                            used += size;
+                        }
+                        if (used >= 0) {
+                            memmove(client->in, client->in + used, client->in_len - used);
+                            client->in_len -= used;
+                        }
+                    }
+
+                    if (r == 0) {
+                        // shut down: the requests already read are answered, an incomplete one is dropped
+                        client->eof = 1;
+                        client->in_len = 0;
+                    } else if ((r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) || used < 0) {
+                        // error, or invalid request: the pending requests of the client are dropped
+                        closed = 1;
                     }
                 }
 
-                if (min_i > tasks[j]->b_rta4) {
-                    min_i = tasks[j]->b_rta4;
+                // a client that shut down its side is closed once its requests are answered
+                if (closed == 0 && client->eof == 1 && client->out_len == 0) {
+                    closed = 1;
+                    for (j = 0; j < num_reqs; j++) {
+                        if (reqs[j].fd == client->fd) {
+                            closed = 0;
+                            break;
+                        }
+                    }
+                }
+
+                if (closed == 1) {
+                    pfds[i] = pfds[num_fds - 1];
+                    serve_close(clients, &num_fds, i, reqs, &num_reqs);
+                    i -= 1;
+                }
+            }
+
+            // the batch window starts with the first request
+            if (num_reqs > 0) {
+                if (timeout < 0) {
+                    clock_gettime(CLOCK_MONOTONIC, &first);
+                }
+                clock_gettime(CLOCK_MONOTONIC, &now);
+                long elapsed = (now.tv_sec - first.tv_sec) * 1000 + (now.tv_nsec - first.tv_nsec) / 1000000;
+                timeout = serve_batch - elapsed;
+                if (timeout <= 0) {
+                    break;
                 }
             }
         }
 
-        tasks[i]->wcrt[RTA4_ID] = tr;
+        // handle the batch
+        for (i = 0; i < num_reqs; ) {
+            if (reqs[i].op != SERVE_QUERY) {
+                serve_update(&reqs[i], &sets, &num_sets);
+                i += 1;
+                continue;
+            }
+
+            for (j = i; j < num_reqs && reqs[j].op == SERVE_QUERY; j++) {
+                ;
+            }
+
+            #pragma omp parallel for schedule(dynamic)
+            for (k = i; k < j; k++) {
+                serve_query(&reqs[k], serve_find(&sets, &num_sets, reqs[k].name, 0));
+            }
+
+            i = j;
+        }
+
+        for (i = 0; i < num_reqs; i++) {
+            for (j = 1; j < num_fds && clients[j].fd != reqs[i].fd; j++) {
+                ;
+            }
+            serve_reply(&reqs[i], &clients[j]);
+        }
+
+        if (verbose == 1 && num_reqs > 0) {
+            fprintf(stderr, "Batch of %d requests.\n", num_reqs);
+        }
+
+        if (telemetry_file != NULL && num_reqs > 0) {
+            telemetry_batch(num_reqs, num_fds - 1, num_sets);
+        }
+
+        // send what the sockets accept, the rest is sent when they are writable
+        num_reqs = 0;
+        for (i = 1; i < num_fds; i++) {
+            if (serve_flush(&clients[i]) < 0 || (clients[i].eof == 1 && clients[i].out_len == 0)) {
+                serve_close(clients, &num_fds, i, reqs, &num_reqs);
+                i -= 1;
+            }
+        }
     }
-	
-    rts->schedulable[RTA4_ID] = SCHED;
-    return SCHED;
+
+    close(clients[0].fd);
+    for (i = 1; i < num_fds; i++) {
+        close(clients[i].fd);
+        free(clients[i].in);
+        free(clients[i].out);
+    }
+    unlink(path);
+
+    return EXIT_SUCCESS;
 }
 
-void reset_rts(struct rts_t *rts)
+/*
+ * Finalizer of splitmix64.
+ */
+uint64_t rng_mix(uint64_t x)
 {
-    int i, j;
-    for (i = 0; i < rts->rts_ntask; i++) {
-        struct task_t *task = rts->tasks[i];
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
 
-        task->a_rta2 = task->c;
-        task->b_rta2 = task->t;
-        task->a_rta3 = task->c;
-        task->b_rta3 = task->t;
-        task->a_rta4 = task->c;
-        task->b_rta4 = task->t;
-        task->last_psi = 0;
-        task->last_workload = 0;
-                       
-        for (j = 0; j < NUM_SCHED_METHODS; j++) {
-            task->cc[j] = 0;
-            task->loops_w[j] = 0;
-            task->loops_f[j] = 0;
-            task->wcrt[j] = 0;
+/*
+ * Random stream number stream of the seed. The values of a stream do not
+ * depend on the thread that draws them, nor on the other streams.
+ */
+void rng_init(struct rng_t *rng, uint64_t seed, uint64_t stream)
+{
+    rng->key = rng_mix(rng_mix(seed) ^ ((stream + 1) * RNG_GOLDEN));
+    rng->ctr = 0;
+}
+
+uint64_t rng_next(struct rng_t *rng)
+{
+    rng->ctr += 1;
+    return rng_mix(rng->key + rng->ctr * RNG_GOLDEN);
+}
+
+/*
+ * Uniform value in [0, 1).
+ */
+double rng_uniform(struct rng_t *rng)
+{
+    return (rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Utilizations of n tasks with total u, with the UUniFast algorithm of Bini
+ * and Buttazzo.
+ */
+void gen_uunifast(struct rng_t *rng, int n, double u, double *ui)
+{
+    int i;
+    double sum = u;
+
+    for (i = 0; i < n - 1; i++) {
+        double next = sum * pow(rng_uniform(rng), 1.0 / (n - i - 1));
+        ui[i] = sum - next;
+        sum = next;
+    }
+    ui[n - 1] = sum;
+}
+
+/*
+ * Period log-uniform in [gen_tmin, gen_tmax]. With gen_harmonic it is rounded
+ * down to gen_tmin * 2^k, so each period divides the larger ones.
+ */
+int gen_period(struct rng_t *rng)
+{
+    double lo = log(gen_tmin);
+    double hi = log(gen_tmax + 1.0);
+    int t = (int) exp(lo + rng_uniform(rng) * (hi - lo));
+
+    if (t > gen_tmax) {
+        t = gen_tmax;
+    }
+    if (gen_harmonic == 1) {
+        int h = gen_tmin;
+        while (2 * h <= t) {
+            h = 2 * h;
         }
+        t = h;
     }
+
+    return t;
 }
 
 /*
- * Parse the XML file. If a new RTS is found, it is evalutad with the methods in method array.
+ * Wcet of the task from its utilization and period, in [1, T - 1]. The
+ * deadline is T, or a new one uniform in [C, T] if the current one is not
+ * valid and the deadlines are constrained.
  */
-void processXmlFile(xmlTextReaderPtr reader, struct set_t *rts_set, struct method_t *methods)
+void gen_wcet(struct rng_t *rng, struct gen_task *task)
 {
-    xmlChar *name = xmlTextReaderLocalName(reader);
+    task->c = (int) (task->u * task->t + 0.5);
+    if (task->c < 1) {
+        task->c = 1;
+    }
+    if (task->c >= task->t) {
+        task->c = task->t - 1;
+    }
 
-    // Tag <Set> -- initial tag
-    if (xmlStrcasecmp(name, SET_TAG) == 0) {
-        if (xmlTextReaderNodeType(reader) == ELEMENT) {            
-            xmlChar *c_set_rts_uf = xmlTextReaderGetAttribute(reader, SET_UF_ATTR);
-            xmlChar *c_set_rts_size = xmlTextReaderGetAttribute(reader, SET_SIZE_ATTR);
-            xmlChar *c_set_rts_ntask = xmlTextReaderGetAttribute(reader, SET_RTS_SIZE_ATTR);
+    if (gen_constrained == 0) {
+        task->d = task->t;
+    } else if (task->d < task->c || task->d > task->t) {
+        task->d = task->c + (int) (rng_uniform(rng) * (task->t - task->c + 1));
+    }
+}
 
-            rts_set->set_uf = atoi((char*) c_set_rts_uf);
-            rts_set->set_size = atoi((char*) c_set_rts_size);
-            rts_set->set_rts_ntask = atoi((char*) c_set_rts_ntask);
+/*
+ * Sort the tasks in deadline monotonic order (rate monotonic with implicit
+ * deadlines), which is the priority order of the methods.
+ */
+void gen_sort(struct gen_task *tasks, int n)
+{
+    int i, j;
 
-            xmlFree(c_set_rts_uf);
-            xmlFree(c_set_rts_size);
-            xmlFree(c_set_rts_ntask);
+    for (i = 1; i < n; i++) {
+        struct gen_task task = tasks[i];
+        for (j = i; j > 0 && (tasks[j - 1].d > task.d || (tasks[j - 1].d == task.d && tasks[j - 1].t > task.t)); j--) {
+            tasks[j] = tasks[j - 1];
         }
+        tasks[j] = task;
     }
+}
 
-    // Tag <S> -- RTS
-    if (xmlStrcasecmp(name, S_TAG) == 0) {
-        if (xmlTextReaderNodeType(reader) == ELEMENT) {
-            xmlChar *c_rts_id = xmlTextReaderGetAttribute(reader, RTS_ID_ATTR);
-            xmlChar *c_rts_uf = xmlTextReaderGetAttribute(reader, RTS_UF_ATTR);
+/*
+ * Random rts of gen_ntask tasks, with utilization gen_uf.
+ */
+void gen_rts(struct rng_t *rng, struct gen_task *tasks)
+{
+    int i;
+    double ui[gen_ntask];
 
-            // reserve memory for the rts and add it to rts_list
-            struct rts_t *new_rts = malloc(sizeof(struct rts_t));            
+    gen_uunifast(rng, gen_ntask, gen_uf / 100.0, ui);
+    for (i = 0; i < gen_ntask; i++) {
+        tasks[i].u = ui[i];
+        tasks[i].t = gen_period(rng);
+        tasks[i].d = 0;
+        gen_wcet(rng, &tasks[i]);
+    }
+    gen_sort(tasks, gen_ntask);
+}
 
-            // reserve memory for the methods results
-            new_rts->schedulable = malloc(sizeof(int) * NUM_SCHED_METHODS);
-            // reserve memory for the rts tasks
-            new_rts->tasks = malloc(sizeof(struct task_t*) * rts_set->set_rts_ntask);
+/*
+ * Utilization of the rts, with the integer wcets.
+ */
+double gen_util(struct gen_task *tasks)
+{
+    int i;
+    double u = 0;
 
-            // complete data about this rts
-            new_rts->rts_id = atoi((char*) c_rts_id);
-            new_rts->rts_uf = atoi((char*) c_rts_uf);
-            new_rts->rts_ntask = rts_set->set_rts_ntask;
+    for (i = 0; i < gen_ntask; i++) {
+        u += (double) tasks[i].c / tasks[i].t;
+    }
 
-            // add rts to set
-            rts_set->rts_list[rts_founded] = new_rts;
+    return u;
+}
 
-            // free memory
-            xmlFree(c_rts_id);
-            xmlFree(c_rts_uf);
+/*
+ * Check that gen_uf can be reached by gen_ntask tasks with periods up to
+ * gen_tmax and integer wcets in [1, T - 1]: each task has a utilization of
+ * at least 1 / gen_tmax and at most 1 - 1 / gen_tmax. With gen_harmonic the
+ * largest period is the largest gen_tmin * 2^k up to gen_tmax.
+ */
+int gen_reachable()
+{
+    double u = gen_uf / 100.0;
+    int t_max = gen_tmax;
+
+    if (gen_harmonic == 1) {
+        t_max = gen_tmin;
+        while (2 * t_max <= gen_tmax) {
+            t_max = 2 * t_max;
         }
+    }
 
-        if (xmlTextReaderNodeType(reader) == END_ELEMENT) {            
-            struct rts_t *rts = rts_set->rts_list[rts_founded];
-            reset_rts(rts);
-            
-            // evaluate the methods
-            int i, j;
-            for (i = 0; i < NUM_SCHED_METHODS; i++) {
-                int method_id = methods[i].method_id;
-                rts->schedulable[method_id] = (*methods[i].method)(rts);
+    return (double) gen_ntask / t_max <= u + GEN_UF_TOL && gen_ntask * (1.0 - 1.0 / t_max) >= u - GEN_UF_TOL;
+}
 
-                // store totals
-                for (j = 0; j < rts->rts_ntask; j++) {
-                    struct task_t *task = rts->tasks[j];
-                    methods[i].result->cc[rts_founded] += task->cc[method_id];
-                    methods[i].result->loops[rts_founded] += task->loops_w[method_id] + task->loops_f[method_id];
-                }
+/*
+ * Cost of the rts with the method: the sum of the ceil operations or loops
+ * of its tasks, or the min time of SEARCH_NSECS_RUNS evaluations. sched is
+ * set to 1 if the rts is schedulable.
+ */
+double search_cost(struct gen_task *tasks, int method_id, int metric, int *sched)
+{
+    int i, k;
+    int n = gen_ntask;
+    int c[n], t[n], d[n], wcrt[n], cc[n], loops_w[n], loops_f[n];
+    double cost = 0;
+
+    for (i = 0; i < n; i++) {
+        c[i] = tasks[i].c;
+        t[i] = tasks[i].t;
+        d[i] = tasks[i].d;
+    }
+
+    if (metric == BUCKET_NSECS) {
+        for (k = 0; k < SEARCH_NSECS_RUNS; k++) {
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            *sched = analyse_tasks(n, c, t, d, method_id, wcrt, NULL, NULL, NULL) == SCHED;
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            double ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+            if (k == 0 || ns < cost) {
+                cost = ns;
             }
+        }
+    } else {
+        *sched = analyse_tasks(n, c, t, d, method_id, wcrt, cc, loops_w, loops_f) == SCHED;
+        for (i = 0; i < n; i++) {
+            cost += metric == BUCKET_CC ? cc[i] : loops_w[i] + loops_f[i];
+        }
+    }
+
+    return cost;
+}
+
+/*
+ * Mutate a task of the rts: move utilization between it and other task
+ * (keeping the total, as UUniFast with two tasks), or draw a new period, or
+ * a new deadline if the deadlines are constrained.
+ */
+void search_mutate(struct rng_t *rng, struct gen_task *tasks)
+{
+    int n = gen_ntask;
+    int i = rng_next(rng) % n;
+    int kind = rng_next(rng) % (gen_constrained == 1 ? 3 : 2);
+
+    if (kind == 0 && n > 1) {
+        int j = (i + 1 + rng_next(rng) % (n - 1)) % n;
+        double sum = tasks[i].u + tasks[j].u;
+        tasks[i].u = sum * rng_uniform(rng);
+        tasks[j].u = sum - tasks[i].u;
+        gen_wcet(rng, &tasks[j]);
+    } else if (kind == 2) {
+        tasks[i].d = -1;
+    } else {
+        tasks[i].t = gen_period(rng);
+    }
+    gen_wcet(rng, &tasks[i]);
+
+    gen_sort(tasks, n);
+}
+
+/*
+ * Search the rts with the highest cost of a method, by hill climbing from
+ * search_restarts random rts. spec is method:metric, with metric cc, loops
+ * or nsecs. The best rts of each restart are written to out_file in the XML
+ * format of the input files, from the most to the least costly. The result
+ * does not depend on the number of threads, except with nsecs.
+ */
+int search(char *spec, struct method_t *methods)
+{
+    int i, k, r;
+    int method_id = -1;
+    int metric = -1;
 
-            rts_founded = rts_founded + 1;
+    char *sep = strchr(spec, ':');
+    if (sep != NULL) {
+        *sep = '\0';
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (strcmp(spec, methods[i].method_name) == 0) {
+                method_id = methods[i].method_id;
+            }
         }
+        for (i = 0; i < NUM_BUCKET_METRICS; i++) {
+            if (strcmp(sep + 1, metric_names[i]) == 0) {
+                metric = i;
+            }
+        }
+    }
+    if (method_id < 0 || metric < 0) {
+        fprintf(stderr, "Invalid search: method:metric, with metric cc, loops or nsecs.\n");
+        return EXIT_FAILURE;
+    }
+    if (gen_constrained == 1 && method_id != RTA_ID) {
+        fprintf(stderr, "--constrained needs the search of rta (the other methods assume D = T).\n");
+        return EXIT_FAILURE;
+    }
+    if (gen_ntask < 1 || gen_uf <= 0 || gen_tmin < 2 || gen_tmax < gen_tmin || search_restarts < 1 || search_iters < 0) {
+        fprintf(stderr, "Invalid number of tasks, utilization, period range, restarts or iterations.\n");
+        return EXIT_FAILURE;
+    }
+    if (gen_reachable() == 0) {
+        fprintf(stderr, "Utilization %d%% not reachable by %d tasks with periods %d_%d.\n", gen_uf, gen_ntask, gen_tmin,
+                gen_tmax);
+        return EXIT_FAILURE;
     }
 
-    // Tag <i> -- a real-time task
-    if (xmlStrcasecmp(name, I_TAG) == 0) {
-        xmlChar *c_id = xmlTextReaderGetAttribute(reader, ID_ATTR);
-        xmlChar *wcet = xmlTextReaderGetAttribute(reader, WCET_ATTR);
-        xmlChar *t = xmlTextReaderGetAttribute(reader, T_ATTR);
-        xmlChar *d = xmlTextReaderGetAttribute(reader, D_ATTR);
+    int n = gen_ntask;
+    struct gen_task *best = malloc(sizeof(struct gen_task) * n * search_restarts);
+    double *best_cost = malloc(sizeof(double) * search_restarts);
+    int *best_sched = malloc(sizeof(int) * search_restarts);
+    long evals = 0;
 
-        int id = atoi((char*) c_id) - 1;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
 
-        struct rts_t *rts = rts_set->rts_list[rts_founded];
-        
-        // reserve memory for the task
-        struct task_t *task = malloc(sizeof(struct task_t));
+    #pragma omp parallel for schedule(dynamic) private(k) reduction(+:evals)
+    for (r = 0; r < search_restarts; r++) {
+        struct rng_t rng;
+        struct gen_task *cur = best + r * n;
+        struct gen_task cand[n];
+        int sched, cand_sched;
 
-        // complete the basic task data
-        task->id = id + 1;
-        task->c = atoi((char*) wcet);
-        task->t = atoi((char*) t);
-        task->d = atoi((char*) d);
-        task->tmc = task->t - task->c;
+        rng_init(&rng, gen_seed, r);
+        gen_rts(&rng, cur);
+        double cost = search_cost(cur, method_id, metric, &sched);
+        double dev = fabs(gen_util(cur) - gen_uf / 100.0);
+        evals += 1;
 
-        // add the task to rts
-        rts->tasks[id] = task;
+        for (k = 0; k < search_iters; k++) {
+            memcpy(cand, cur, sizeof(struct gen_task) * n);
+            search_mutate(&rng, cand);
 
-        xmlFree(c_id);
-        xmlFree(wcet);
-        xmlFree(t);
-        xmlFree(d);       
+            // the rounding of the wcets must not move the utilization away from gen_uf
+            double cand_dev = fabs(gen_util(cand) - gen_uf / 100.0);
+            if (cand_dev > GEN_UF_TOL && cand_dev >= dev) {
+                continue;
+            }
+
+            double cand_cost = search_cost(cand, method_id, metric, &cand_sched);
+            evals += 1;
+
+            // moves that do not lower the cost are accepted, to cross plateaus
+            if (cand_cost >= cost || (dev > GEN_UF_TOL && cand_dev < dev)) {
+                memcpy(cur, cand, sizeof(struct gen_task) * n);
+                cost = cand_cost;
+                sched = cand_sched;
+                dev = cand_dev;
+            }
+        }
+
+        best_cost[r] = cost;
+        best_sched[r] = sched;
+
+        if (verbose == 1) {
+            fprintf(stderr, "Restart %d: %s %.0f.\n", r + 1, metric_names[metric], cost);
+        }
     }
 
-    xmlFree(name);
-}
+    clock_gettime(CLOCK_MONOTONIC, &end);
 
-/*
- * Evaluate the schedulability of the rts in the specified xml file.
- */ 
-void testRtsInXml(char *file, struct set_t* rts_set, struct method_t *methods, int limit)
-{    
-    // get read pointer
-    xmlTextReaderPtr reader = xmlNewTextReaderFilename(file);
-    if (reader == NULL) {
-        fprintf(stderr, "Unable to open %s\n", file);
-        exit(EXIT_FAILURE);
+    // restarts from the most to the least costly rts
+    int order[search_restarts];
+    for (r = 0; r < search_restarts; r++) {
+        for (i = r; i > 0 && best_cost[order[i - 1]] < best_cost[r]; i--) {
+            order[i] = order[i - 1];
+        }
+        order[i] = r;
     }
 
-    // parse xml file and evaluate schedulability methods
-    int ret = xmlTextReaderRead(reader);
-    while (ret == 1) {
-        if (limit > 0 && rts_founded == limit) {
-            break;
+    double sum = 0;
+    int off_target = 0;
+    fprintf(out_file, "<?xml version=\"1.0\"?>\n");
+    fprintf(out_file, "<Set size=\"%d\" n=\"%d\" u=\"%d\">\n", search_restarts, n, gen_uf);
+    for (k = 0; k < search_restarts; k++) {
+        r = order[k];
+        struct gen_task *tasks = best + r * n;
+        double u = gen_util(tasks);
+        sum += best_cost[r];
+        if (fabs(u - gen_uf / 100.0) > GEN_UF_TOL) {
+            off_target += 1;
         }
-        processXmlFile(reader, rts_set, methods);
-        ret = xmlTextReaderRead(reader);
+
+        fprintf(out_file, "<!-- restart %d, %s %s %.0f, %s -->\n", r + 1, spec, metric_names[metric], best_cost[r],
+                best_sched[r] == 1 ? "sched" : "non sched");
+        fprintf(out_file, "<S count=\"%d\" U=\"%d\">\n", k + 1, (int) (u * 100 + 0.5));
+        for (i = 0; i < n; i++) {
+            fprintf(out_file, "<i nro=\"%d\" C=\"%d\" T=\"%d\" D=\"%d\"/>\n", i + 1, tasks[i].c, tasks[i].t, tasks[i].d);
+        }
+        fprintf(out_file, "</S>\n");
     }
+    fprintf(out_file, "</Set>\n");
 
-    if (rts_set->set_size < limit) {
-        fprintf(stderr, "Warning: %d str in file according to XML info, but %d to be tested.\n", rts_set->set_size, limit);
+    fprintf(stderr, "Search: %s %s, max %.0f, mean %.0f, %ld rts evaluated in %.3f secs.\n", spec, metric_names[metric],
+            best_cost[order[0]], sum / search_restarts, evals,
+            (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9);
+    if (off_target > 0) {
+        fprintf(stderr, "Warning: %d of %d rts with a utilization off %d%% by more than %.1f%% (use more iterations "
+                "or longer periods).\n", off_target, search_restarts, gen_uf, GEN_UF_TOL * 100);
     }
 
-    xmlFreeTextReader(reader);
+    free(best);
+    free(best_cost);
+    free(best_sched);
+
+    return EXIT_SUCCESS;
 }
 
 /*
- * Print method results to out_file.
+ * Evaluate limit random rts, of gen_ntask tasks with utilization gen_uf.
+ * Each batch of GEN_BATCH rts is generated in parallel and then evaluated
+ * in order, so the results do not depend on the number of threads. The rts
+ * still further than GEN_UF_TOL from gen_uf after GEN_TRIES draws (short
+ * periods, where the wcets are rounded the most) are evaluated, and counted
+ * in a warning.
  */
-void save_result(char* method, struct result_t* result, int use_csv, char *csv_sep)
+void testRtsGenerated(struct set_t *rts_set, struct method_t *methods, int limit)
 {
-    if (use_csv == 0) {
-        fprintf(out_file, "%10s%15f%15f%15f%15f\n", method, result->cc_mean, result->cc_std, 
-                                                    result->loops_mean, result->loops_std);
-    } else {
-        fprintf(out_file, "%2$s%1$s%3$f%1$s%4$f%1$s%5$f%1$s%6$f\n", csv_sep, method, result->cc_mean, result->cc_std, 
-                                                                                     result->loops_mean, result->loops_std);
-    }    
+    int i, k, first;
+    int off_target = 0;
+
+    rts_set->set_uf = gen_uf;
+    rts_set->set_size = limit;
+    rts_set->set_rts_ntask = gen_ntask;
+
+    for (first = 0; first < limit; first += GEN_BATCH) {
+        int last = (first + GEN_BATCH < limit) ? first + GEN_BATCH : limit;
+
+        #pragma omp parallel for schedule(static) private(i) reduction(+:off_target)
+        for (k = first; k < last; k++) {
+            struct rng_t rng;
+            struct gen_task tasks[gen_ntask];
+            int tries = 0;
+
+            rng_init(&rng, gen_seed, k);
+            do {
+                gen_rts(&rng, tasks);
+                tries += 1;
+            } while (tries < GEN_TRIES && fabs(gen_util(tasks) - gen_uf / 100.0) > GEN_UF_TOL);
+            if (fabs(gen_util(tasks) - gen_uf / 100.0) > GEN_UF_TOL) {
+                off_target += 1;
+            }
+
+            struct rts_t *new_rts = malloc(sizeof(struct rts_t));
+            new_rts->schedulable = malloc(sizeof(int) * NUM_SCHED_METHODS);
+            new_rts->tasks = malloc(sizeof(struct task_t*) * gen_ntask);
+            new_rts->rts_id = k + 1;
+            new_rts->rts_uf = gen_uf;
+            new_rts->rts_ntask = gen_ntask;
+            new_rts->harmonic = 0;
+            new_rts->chains = 0;
+            new_rts->auto_method = 0;
+            new_rts->trace = 0;
+            new_rts->attribution = 0;
+
+            for (i = 0; i < gen_ntask; i++) {
+                struct task_t *task = malloc(sizeof(struct task_t));
+                task->id = i + 1;
+                task->c = tasks[i].c;
+                task->t = tasks[i].t;
+                task->d = tasks[i].d;
+                task->tmc = task->t - task->c;
+                new_rts->tasks[i] = task;
+            }
+
+            rts_set->rts_list[k] = new_rts;
+        }
+
+        for (k = first; k < last; k++) {
+            testRts(rts_set->rts_list[k], methods);
+        }
+    }
+
+    if (off_target > 0) {
+        fprintf(stderr, "Warning: %d of %d rts with a utilization off %d%% by more than %.1f%% after %d draws "
+                "(use longer periods).\n", off_target, limit, gen_uf, GEN_UF_TOL * 100, GEN_TRIES);
+    }
 }
 
 /*
@@ -604,10 +5815,58 @@ void printUsage(char* progName, int exitCode)
             "\t-v  --verbose\tDisplay additional information about the clock used.\n"
             "\t-h  --help\tDisplay this information.\n"
             "\t-l  --limit\tTest first n RTS in file.\n"
-            "\t-c  --csv\tCSV output with specified line separator.\n");
+            "\t-c  --csv\tCSV output with specified line separator.\n"
+            "\t-p  --param\tPrint the wcrt of the tasks as a function of the wcet of task n.\n"
+            "\t-r  --param-range\tRange lo:hi of wcet values for --param (default C:D).\n"
+            "\t-o  --opa\tPrint the optimal priority assignment (Audsley) of each RTS.\n"
+            "\t-s  --screen\tScreen the RTS with sufficient tests before the exact methods.\n"
+            "\t-S  --seed\tInitial value of the RTA iterations: sjodin (default), uf or max.\n"
+            "\t-H  --harmonic\tClosed form wcrt for harmonic RTS in RM order.\n"
+            "\t-q  --merge\tMerge consecutive tasks with equal period and deadline before the evaluation.\n"
+            "\t-F  --fail-fast\tTest first the task most likely to miss its deadline, and settle the RTS if it does.\n"
+            "\t-V  --verify\tWith --fail-fast, also evaluate the methods with the RTS it settles, and count the cc saved.\n"
+            "\t-m  --methods\tComma separated list of methods to evaluate (default het,rta,rta2,rta3,rta4).\n"
+            "\t-M  --mem\tMeasure the stack and heap used by each method.\n"
+            "\t-A  --attribution\tWrite the ceil operations caused by each higher priority task to file (make ATTRIBUTION=1).\n"
+            "\t-T  --trace\tWrite each update of the wcrt of the RTA methods to a binary file (see wcrt-trace.py, make TRACE=1).\n"
+            "\t-N  --nsecs\tPrint the time used by each method.\n"
+            "\t-f  --features\tWrite the features and cost of each RTS to file, to train auto (see wcrt-auto.py).\n"
+            "\t-B  --budget\tBudget type:amount of each rta4a slice, with type cc, iter or ns.\n"
+            "\t-D  --serve\tRun as an admission control service on the given Unix socket (no file).\n"
+            "\t-b  --batch\tTime window in msecs of a batch of requests for --serve (default 1).\n"
+            "\t-K  --key\tRead the rts from the table key of a HDF5 store, as used by wcrt-test-mbed.py.\n"
+            "\t-W  --where\tCondition of the rows read from the HDF5 store, as in pandas (e.g. \"ntask=10 & uf<=80\").\n"
+            "\t-R  --results\tAppend the results of each RTS to a columnar file (see wcrt_results.py).\n"
+            "\t-d  --detail\tAlso write the results of each task to the --results file.\n"
+            "\t-z  --compress\tzlib level (1-9) of the --results file (default 0, not compressed).\n"
+            "\t-O  --store\tSave the results into a HDF5 store, with the schema of wcrt-test-mbed.py.\n"
+            "\t-k  --store-key\tKey of the results in the --store (default /sim).\n"
+            "\t-u  --buckets\tWrite the acceptance ratio and the cost of each method by uf and number of tasks to file.\n"
+            "\t-Q  --sketch\tQuantiles of cc, loops and nsecs of each method, merged into the sketches saved in file.\n"
+            "\t-C  --cache\tRead the results of each method with a rts from the cache file, or save them into it.\n"
+            "\t-n  --no-cache\tEvaluate the methods even if their results are in the --cache (the new results are saved).\n"
+            "\t-P  --checkpoint\tSave the results into file periodically.\n"
+            "\t-I  --checkpoint-secs\tTime between checkpoints, in secs (default 60).\n"
+            "\t-e  --resume\tContinue from the last --checkpoint.\n"
+            "\t-t  --telemetry\tWrite the progress as JSON lines to file (- for stderr).\n"
+            "\t-i  --telemetry-secs\tTime between telemetry lines, in secs (default 5).\n"
+            "\t-x  --search\tSearch the rts with the highest method:metric (cc, loops or nsecs), and write them as XML (no file).\n"
+            "\t-j  --search-iters\tIterations of each restart of the --search (default 1000).\n"
+            "\t-J  --search-restarts\tRestarts of the --search, run in parallel (default 16).\n"
+            "\t-L  --ntask\tNumber of tasks of the random rts (default 10).\n"
+            "\t-U  --uf\tUtilization of the random rts, in %% (default 90).\n"
+            "\t-Y  --trange\tRange lo_hi of the log-uniform periods of the random rts (default 25_1000).\n"
+            "\t-E  --constrained\tDeadlines of the random rts uniform in [C, T] (default D = T), only with rta.\n"
+            "\t-X  --harmonic-periods\tPeriods of the random rts rounded down to lo * 2^k, so they are harmonic.\n"
+            "\t-G  --gen-seed\tSeed of the random rts (default 1).\n"
+            "\t-g  --generate\tEvaluate --limit random rts with --ntask, --uf, --trange, --constrained and -X (no file).\n");
     exit(exitCode);
 }
 
+/*
+ * Defined by wcrtmodule.c, which includes this file to build the Python module.
+ */
+#ifndef WCRT_NO_MAIN
 int main(int argc, char **argv)
 {
     int i, j, k;
@@ -617,13 +5876,57 @@ int main(int argc, char **argv)
     }
 
     // options -- short format
-    const char *shortOpts = "hvl:c:";
+    const char *shortOpts = "hvl:c:p:r:osS:HqFVm:MA:T:Nf:B:D:b:K:W:R:dz:O:k:u:Q:C:nP:I:et:i:x:j:J:L:U:Y:EXG:g";
     // options -- long format
     const struct option longOpts[] = {
         {"help",    no_argument,        NULL, 'h'},
         {"verbose", no_argument,        NULL, 'v'},
         {"limit",   required_argument,  NULL, 'l'},
         {"csv",     required_argument,  NULL, 'c'},
+        {"param",   required_argument,  NULL, 'p'},
+        {"param-range", required_argument, NULL, 'r'},
+        {"opa",     no_argument,        NULL, 'o'},
+        {"screen",  no_argument,        NULL, 's'},
+        {"seed",    required_argument,  NULL, 'S'},
+        {"harmonic", no_argument,       NULL, 'H'},
+        {"merge",   no_argument,        NULL, 'q'},
+        {"fail-fast", no_argument,      NULL, 'F'},
+        {"verify",  no_argument,        NULL, 'V'},
+        {"methods", required_argument,  NULL, 'm'},
+        {"mem",     no_argument,        NULL, 'M'},
+        {"attribution", required_argument, NULL, 'A'},
+        {"trace",   required_argument,  NULL, 'T'},
+        {"nsecs",   no_argument,        NULL, 'N'},
+        {"features", required_argument, NULL, 'f'},
+        {"budget",  required_argument,  NULL, 'B'},
+        {"serve",   required_argument,  NULL, 'D'},
+        {"batch",   required_argument,  NULL, 'b'},
+        {"key",     required_argument,  NULL, 'K'},
+        {"where",   required_argument,  NULL, 'W'},
+        {"results", required_argument,  NULL, 'R'},
+        {"detail",  no_argument,        NULL, 'd'},
+        {"compress", required_argument, NULL, 'z'},
+        {"store",   required_argument,  NULL, 'O'},
+        {"buckets", required_argument,  NULL, 'u'},
+        {"sketch",  required_argument,  NULL, 'Q'},
+        {"cache",   required_argument,  NULL, 'C'},
+        {"no-cache", no_argument,       NULL, 'n'},
+        {"checkpoint", required_argument, NULL, 'P'},
+        {"checkpoint-secs", required_argument, NULL, 'I'},
+        {"resume",  no_argument,        NULL, 'e'},
+        {"telemetry", required_argument, NULL, 't'},
+        {"telemetry-secs", required_argument, NULL, 'i'},
+        {"search",  required_argument,  NULL, 'x'},
+        {"search-iters", required_argument, NULL, 'j'},
+        {"search-restarts", required_argument, NULL, 'J'},
+        {"ntask",   required_argument,  NULL, 'L'},
+        {"uf",      required_argument,  NULL, 'U'},
+        {"trange",  required_argument,  NULL, 'Y'},
+        {"constrained", no_argument,    NULL, 'E'},
+        {"harmonic-periods", no_argument, NULL, 'X'},
+        {"gen-seed", required_argument, NULL, 'G'},
+        {"generate", no_argument,       NULL, 'g'},
+        {"store-key", required_argument, NULL, 'k'},
         {0, 0, 0, 0}
     };
 
@@ -634,6 +5937,11 @@ int main(int argc, char **argv)
     int use_csv = 0;
     char* csv_sep;
 
+    char *method_list = NULL;
+    char *results_path = NULL;
+    char *cache_path = NULL;
+    char *ckpt_path = NULL;
+
     int nextOption;
 
     do {
@@ -651,6 +5959,200 @@ int main(int argc, char **argv)
                 use_csv = 1;
                 csv_sep = optarg;
                 break;
+            case 'p': // -p or --param
+                param_task = atoi(optarg) - 1;
+                break;
+            case 'r': // -r or --param-range
+                if (sscanf(optarg, "%d:%d", &param_lo, &param_hi) != 2) {
+                    printUsage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'o': // -o or --opa
+                opa = 1;
+                break;
+            case 's': // -s or --screen
+                screen = 1;
+                break;
+            case 'S': // -S or --seed
+                for (seed_type = 0; seed_type < NUM_SEED_TYPES; seed_type++) {
+                    if (strcmp(optarg, seed_names[seed_type]) == 0) {
+                        break;
+                    }
+                }
+                if (seed_type == NUM_SEED_TYPES) {
+                    printUsage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'H': // -H or --harmonic
+                harmonic = 1;
+                break;
+            case 'q': // -q or --merge
+                merge = 1;
+                break;
+            case 'F': // -F or --fail-fast
+                fail_fast = 1;
+                break;
+            case 'V': // -V or --verify
+                fail_fast_verify = 1;
+                break;
+            case 'm': // -m or --methods
+                method_list = optarg;
+                break;
+            case 'M': // -M or --mem
+                mem = 1;
+                break;
+            case 'A': // -A or --attribution
+#ifndef USE_ATTRIBUTION
+                fprintf(stderr, "Attribution is not supported (build with make ATTRIBUTION=1).\n");
+                exit(EXIT_FAILURE);
+#endif
+                attribution = 1;
+                attr_file = fopen(optarg, "w");
+                if (attr_file == NULL) {
+                    perror(optarg);
+                    exit(EXIT_FAILURE);
+                }
+                fprintf(attr_file, "type,rts_id,method,i,j,cc,exp\n");
+                break;
+            case 'N': // -N or --nsecs
+                nsecs = 1;
+                break;
+            case 'f': // -f or --features
+                features_file = fopen(optarg, "w");
+                if (features_file == NULL) {
+                    perror(optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'B': // -B or --budget
+                for (budget_type = 0; budget_type < NUM_BUDGET_TYPES; budget_type++) {
+                    int len = strlen(budget_names[budget_type]);
+                    if (strncmp(optarg, budget_names[budget_type], len) == 0 && optarg[len] == ':') {
+                        budget = atol(optarg + len + 1);
+                        break;
+                    }
+                }
+                if (budget_type == NUM_BUDGET_TYPES || budget <= 0) {
+                    printUsage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'D': // -D or --serve
+                serve_path = optarg;
+                break;
+            case 'b': // -b or --batch
+                serve_batch = atoi(optarg);
+                break;
+            case 'K': // -K or --key
+#ifndef USE_HDF5
+                fprintf(stderr, "HDF5 stores are not supported (build with make HDF5=1).\n");
+                exit(EXIT_FAILURE);
+#endif
+                hdf5_key = optarg;
+                break;
+            case 'O': // -O or --store
+#ifndef USE_HDF5
+                fprintf(stderr, "HDF5 stores are not supported (build with make HDF5=1).\n");
+                exit(EXIT_FAILURE);
+#endif
+                store_path = optarg;
+                break;
+            case 'k': // -k or --store-key
+                store_key = optarg;
+                break;
+            case 'W': // -W or --where
+                hdf5_where = optarg;
+                break;
+            case 'u': // -u or --buckets
+                buckets_file = fopen(optarg, "w");
+                if (buckets_file == NULL) {
+                    perror(optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'Q': // -Q or --sketch
+                sketch_path = optarg;
+                break;
+            case 'C': // -C or --cache
+                cache_path = optarg;
+                break;
+            case 'n': // -n or --no-cache
+                no_cache = 1;
+                break;
+            case 'P': // -P or --checkpoint
+                ckpt_path = optarg;
+                break;
+            case 'I': // -I or --checkpoint-secs
+                ckpt_secs = atoi(optarg);
+                break;
+            case 'e': // -e or --resume
+                ckpt_resume = 1;
+                break;
+            case 't': // -t or --telemetry
+                telemetry_file = strcmp(optarg, "-") == 0 ? stderr : fopen(optarg, "w");
+                if (telemetry_file == NULL) {
+                    perror(optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'i': // -i or --telemetry-secs
+                telemetry_secs = atoi(optarg);
+                break;
+            case 'x': // -x or --search
+                search_spec = optarg;
+                break;
+            case 'j': // -j or --search-iters
+                search_iters = atoi(optarg);
+                break;
+            case 'J': // -J or --search-restarts
+                search_restarts = atoi(optarg);
+                break;
+            case 'L': // -L or --ntask
+                gen_ntask = atoi(optarg);
+                break;
+            case 'U': // -U or --uf
+                gen_uf = atoi(optarg);
+                break;
+            case 'Y': // -Y or --trange
+                if (sscanf(optarg + (optarg[0] == 't'), "%d_%d", &gen_tmin, &gen_tmax) != 2) {
+                    printUsage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'E': // -E or --constrained
+                gen_constrained = 1;
+                break;
+            case 'X': // -X or --harmonic-periods
+                gen_harmonic = 1;
+                break;
+            case 'G': // -G or --gen-seed
+                gen_seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'g': // -g or --generate
+                generate = 1;
+                break;
+            case 'R': // -R or --results
+                results_path = optarg;
+                break;
+            case 'd': // -d or --detail
+                col_detail = 1;
+                break;
+            case 'z': // -z or --compress
+                col_level = atoi(optarg);
+                if (col_level < 0 || col_level > 9) {
+                    printUsage(argv[0], EXIT_FAILURE);
+                }
+                break;
+            case 'T': // -T or --trace
+#ifndef USE_TRACE
+                fprintf(stderr, "Traces are not supported (build with make TRACE=1).\n");
+                exit(EXIT_FAILURE);
+#endif
+                trace = 1;
+                trace_file = fopen(optarg, "wb");
+                if (trace_file == NULL) {
+                    perror(optarg);
+                    exit(EXIT_FAILURE);
+                }
+                break;
             case '?': // invalid option
                 printUsage(argv[0], EXIT_FAILURE);
             case -1: // no more options
@@ -659,10 +6161,41 @@ int main(int argc, char **argv)
                 abort();
         }
     } while (nextOption != -1);
-    
+
+    clock_gettime(CLOCK_MONOTONIC, &telemetry_start);
+    telemetry_last = telemetry_start;
+
+    // the methods of the service and the search run in several threads, without the global trace state
+    if ((serve_path != NULL || search_spec != NULL) && (trace == 1 || attribution == 1)) {
+        fprintf(stderr, "--trace and --attribution are not supported with --serve or --search.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (serve_path != NULL) {
+        return serve(serve_path);
+    }
+
+    // input file, or the parameters of the random rts
+    char *filename = argv[optind];
+    char gen_name[128];
+    if (generate == 1) {
+        if (limit <= 0 || gen_ntask < 1 || gen_uf <= 0 || gen_tmin < 2 || gen_tmax < gen_tmin) {
+            printUsage(argv[0], EXIT_FAILURE);
+        }
+        if (gen_reachable() == 0) {
+            fprintf(stderr, "Utilization %d%% not reachable by %d tasks with periods %d_%d.\n", gen_uf, gen_ntask,
+                    gen_tmin, gen_tmax);
+            exit(EXIT_FAILURE);
+        }
+        snprintf(gen_name, sizeof(gen_name), "generated n=%d u=%d t=%d_%d%s d=%s seed=%llu", gen_ntask, gen_uf,
+                 gen_tmin, gen_tmax, gen_harmonic == 1 ? " harmonic" : "", gen_constrained == 1 ? "constrained" : "implicit",
+                 (unsigned long long) gen_seed);
+        filename = gen_name;
+    }
+
     // print info to stderr if requested
-    if (verbose == 1) {
-        fprintf(stderr, "Testing %s...\n", argv[optind]);
+    if (verbose == 1 && filename != NULL) {
+        fprintf(stderr, "Testing %s...\n", filename);
     }
 
     // stdout as default output file
@@ -681,35 +6214,154 @@ int main(int argc, char **argv)
     struct result_t* rta2_results = malloc(sizeof(struct result_t));
     struct result_t* rta3_results = malloc(sizeof(struct result_t));
     struct result_t* rta4_results = malloc(sizeof(struct result_t));
+    struct result_t* heti_results = malloc(sizeof(struct result_t));
+    struct result_t* auto_results = malloc(sizeof(struct result_t));
+    struct result_t* rta4a_results = malloc(sizeof(struct result_t));
 
     // methods to test
-    struct method_t methods[] = {[RTA_ID]  {RTA,  RTA_ID,  rta_wcrt,  rta_results},
-                                 [RTA2_ID] {RTA2, RTA2_ID, rta2_wcrt, rta2_results},
-                                 [RTA3_ID] {RTA3, RTA3_ID, rta3_wcrt, rta3_results},
-                                 [RTA4_ID] {RTA4, RTA4_ID, rta4_wcrt, rta4_results},
-                                 [HET_ID]  {HET,  HET_ID,  het_wcrt,  het_results}
+    struct method_t methods[] = {[RTA_ID]  {RTA,  RTA_ID,  rta_wcrt,  rta_results,  1},
+                                 [RTA2_ID] {RTA2, RTA2_ID, rta2_wcrt, rta2_results, 1},
+                                 [RTA3_ID] {RTA3, RTA3_ID, rta3_wcrt, rta3_results, 1},
+                                 [RTA4_ID] {RTA4, RTA4_ID, rta4_wcrt, rta4_results, 1},
+                                 [HET_ID]  {HET,  HET_ID,  het_wcrt,  het_results,  1},
+                                 [HETI_ID] {HETI, HETI_ID, heti_wcrt, heti_results, 0},
+                                 [AUTO_ID] {AUTO, AUTO_ID, auto_wcrt, auto_results, 0},
+                                 [RTA4A_ID] {RTA4A, RTA4A_ID, rta4a_wcrt, rta4a_results, 0}
                                  };
 
+    // enable only the methods in the list
+    if (method_list != NULL) {
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            methods[i].enabled = 0;
+        }
+        char *name = strtok(method_list, ",");
+        while (name != NULL) {
+            for (i = 0; i < NUM_SCHED_METHODS; i++) {
+                if (strcmp(name, methods[i].method_name) == 0) {
+                    methods[i].enabled = 1;
+                    break;
+                }
+            }
+            if (i == NUM_SCHED_METHODS) {
+                fprintf(stderr, "Unknown method: %s\n", name);
+                printUsage(argv[0], EXIT_FAILURE);
+            }
+            name = strtok(NULL, ",");
+        }
+    }
+
+    if (search_spec != NULL) {
+        return search(search_spec, methods);
+    }
+
+    // number of methods enabled, and the one used as reference
+    int num_enabled = 0;
+    int ref_id = -1;
+    for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 1) {
+            num_enabled += 1;
+            if (ref_id < 0) {
+                ref_id = methods[i].method_id;
+            }
+        }
+    }
+    if (num_enabled == 0) {
+        printUsage(argv[0], EXIT_FAILURE);
+    }
+
+    // the methods other than rta assume D = T
+    if (generate == 1 && gen_constrained == 1 && (num_enabled != 1 || methods[RTA_ID].enabled == 0)) {
+        fprintf(stderr, "--constrained needs -m rta (the other methods assume D = T).\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the condition selects rows of a HDF5 store
+    if (hdf5_where != NULL && hdf5_key == NULL) {
+        fprintf(stderr, "--where needs --key.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // the outputs of each rts are not in the checkpoints
+    if (ckpt_resume == 1 && (ckpt_path == NULL || features_file != NULL || results_path != NULL ||
+                             store_path != NULL || trace == 1 || attribution == 1 || opa == 1 || param_task >= 0)) {
+        fprintf(stderr, "--resume needs --checkpoint, and can not be used with --features, --results, --store, "
+                        "--trace, --attribution, --opa or --param.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (results_path != NULL) {
+        col_open(results_path, methods);
+    }
+
+#ifdef USE_HDF5
+    if (store_path != NULL) {
+        store_open(store_path, store_key, filename, limit, methods);
+    }
+#endif
+
+    if (cache_path != NULL) {
+        cache_open(cache_path);
+    }
+
+    // trace header: magic, record size, number of methods and their names
+    // features header: rts, features, and time and ceil operations of each method
+    if (features_file != NULL) {
+        fprintf(features_file, "rts_id,n,u,ratio,harmonic");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (methods[i].enabled == 1) {
+                fprintf(features_file, ",%1$s_nsecs,%1$s_cc", methods[i].method_name);
+            }
+        }
+        fprintf(features_file, "\n");
+    }
+
+    if (trace == 1) {
+        uint32_t header[2] = {sizeof(struct trace_rec), NUM_SCHED_METHODS};
+        char method_name[8];
+        fwrite(TRACE_MAGIC, 1, 8, trace_file);
+        fwrite(header, sizeof(uint32_t), 2, trace_file);
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            memset(method_name, 0, 8);
+            strncpy(method_name, methods[i].method_name, 7);
+            fwrite(method_name, 1, 8, trace_file);
+        }
+    }
+
     for (i = 0; i < NUM_SCHED_METHODS; i++) {
         methods[i].result->cc = calloc(limit, sizeof(double));
         methods[i].result->loops = calloc(limit, sizeof(double));
+        methods[i].result->nsecs = calloc(limit, sizeof(double));
+        methods[i].result->stack = calloc(limit, sizeof(double));
+        methods[i].result->stack_max = 0;
+        methods[i].result->heap_max = 0;
     }
 
+    settled = calloc(limit, sizeof(char));
+    cached = calloc(limit, sizeof(int32_t));
+
+    if (ckpt_path != NULL) {
+        checkpoint_open(ckpt_path, filename, limit, methods);
+    }
+
+    telemetry_limit = limit;
+
     if (verbose == 1) {
         fprintf(stderr, "Testing %d rts.\n", limit);
     }
 
-    // read rts from xml file into rts_set
-    char *filename = argv[optind];
+    // read rts from xml file (or HDF5 store) into rts_set, or generate them
+    if (generate == 1) {
+        testRtsGenerated(rts_set, methods, limit);
+    } else
+#ifdef USE_HDF5
+    if (hdf5_key != NULL) {
+        testRtsInHdf5(filename, hdf5_key, hdf5_where, rts_set, methods, limit);
+    } else
+#endif
     testRtsInXml(filename, rts_set, methods, limit);
 
     // compute means and stdev
-    for (i = 0; i < NUM_SCHED_METHODS; i++) {
-        methods[i].result->cc_mean = gsl_stats_mean(methods[i].result->cc, 1, rts_founded);
-        methods[i].result->cc_std = gsl_stats_sd_m(methods[i].result->cc, 1, rts_founded, methods[i].result->cc_mean);
-        methods[i].result->loops_mean = gsl_stats_mean(methods[i].result->loops, 1, rts_founded);
-        methods[i].result->loops_std = gsl_stats_sd_m(methods[i].result->loops, 1, rts_founded, methods[i].result->loops_mean);
-    }
+    result_stats(methods, rts_founded);
         
     int rts_sched_cnt = 0; 
     int rts_nonsched_cnt = 0;
@@ -720,39 +6372,59 @@ int main(int argc, char **argv)
 
         int sum = 0;
         for (j = 0; j < NUM_SCHED_METHODS; j++) {
-            sum += rts->schedulable[j];
+            if (methods[j].enabled == 1) {
+                sum += rts->schedulable[j];
+            }
         }
 
-        if (sum > 0 && sum < NUM_SCHED_METHODS) {
+        if (sum > 0 && sum < num_enabled) {
             fprintf(stderr, "Error! Method results are not the same. RTS %d\n", i);
             for (j = 0; j < NUM_SCHED_METHODS; j++) {
-                fprintf(stderr, "%s: %d\n", methods[j].method_name, rts->schedulable[j]);
+                if (methods[j].enabled == 1) {
+                    fprintf(stderr, "%s: %d\n", methods[j].method_name, rts->schedulable[j]);
+                }
             }
             break;
         }
 
-        if (rts->schedulable[RTA_ID] == SCHED) {
+        if (rts->schedulable[ref_id] == SCHED) {
             rts_sched_cnt += 1;
         } else {
             rts_nonsched_cnt += 1; 
         }
     }
     
-    // verify that all wcrt are the same (only for RTA methods)
-    for (j = 0; j < rts_founded; j++) {
+    // verify that all wcrt are the same (only for RTA methods, and HET against HETI)
+    // the wcrt of the rts resumed are not in the checkpoints
+    int rta_ids[] = {RTA_ID, RTA2_ID, RTA3_ID, RTA4_ID, RTA4A_ID};
+    for (j = ckpt_resumed; j < rts_founded; j++) {
         struct rts_t *rts = rts_set->rts_list[j];
         for (k = 0; k < rts->rts_ntask; k++) {
             struct task_t *task = rts->tasks[k];
-            int ref_wcrt = task->wcrt[RTA_ID];
-            if (ref_wcrt != task->wcrt[RTA2_ID] || ref_wcrt != task->wcrt[RTA3_ID] || ref_wcrt != task->wcrt[RTA4_ID]) 
+            int ref_wcrt = -1;
+            int same = 1;
+            for (i = 0; i < 5; i++) {
+                if (methods[rta_ids[i]].enabled == 1) {
+                    if (ref_wcrt < 0) {
+                        ref_wcrt = task->wcrt[rta_ids[i]];
+                    } else if (ref_wcrt != task->wcrt[rta_ids[i]]) {
+                        same = 0;
+                    }
+                }
+            }
+            if (methods[HET_ID].enabled == 1 && methods[HETI_ID].enabled == 1 && task->wcrt[HET_ID] != task->wcrt[HETI_ID]) {
+                same = 0;
+            }
+            if (same == 0) 
             {
                 fprintf(stderr, "Error! WCRT are not the same. RTS %d, task %d\n", j, k);
                 
                 int i = 0;                
-                fprintf(stderr, "%13s%10s%10s%10s%10s%10s\n", "RTA", "RTA2", "RTA3", "RTA4", "C_i", "D_i"); 
+                fprintf(stderr, "%13s%10s%10s%10s%10s%10s%10s%10s\n", "RTA", "RTA2", "RTA3", "RTA4", "HET", "HETI", "C_i", "D_i"); 
                 for (i = 0; i < rts->rts_ntask; i++) {
-                    fprintf(stderr, "%3d%10d%10d%10d%10d%10d%10d\n", i, rts->tasks[i]->wcrt[RTA_ID], rts->tasks[i]->wcrt[RTA2_ID], 
+                    fprintf(stderr, "%3d%10d%10d%10d%10d%10d%10d%10d%10d\n", i, rts->tasks[i]->wcrt[RTA_ID], rts->tasks[i]->wcrt[RTA2_ID], 
                                                                         rts->tasks[i]->wcrt[RTA3_ID], rts->tasks[i]->wcrt[RTA4_ID],
+                                                                        rts->tasks[i]->wcrt[HET_ID], rts->tasks[i]->wcrt[HETI_ID],
                                                                         rts->tasks[i]->c, rts->tasks[i]->d );
                 }
             
@@ -772,6 +6444,169 @@ int main(int argc, char **argv)
     fprintf(out_file, "Total: %d\n", rts_founded);
     fprintf(out_file, "Sched: %d\n", rts_sched_cnt);
     fprintf(out_file, "Non sched: %d\n", rts_nonsched_cnt);
+    if (opa == 1) {
+        fprintf(out_file, "OPA sched: %d\n", opa_sched_cnt);
+        fprintf(out_file, "OPA cc: %ld\n", opa_cc);
+    }
+    if (screen == 1) {
+        fprintf(out_file, "Screen: uf %d, ll %d, hb %d, rtb %d, exact %d\n", screen_cnt[SCREEN_UF], 
+                          screen_cnt[SCREEN_LL], screen_cnt[SCREEN_HB], screen_cnt[SCREEN_RTB], screen_cnt[SCREEN_EXACT]);
+    }
+    if (harmonic == 1) {
+        fprintf(out_file, "Harmonic: closed form %d, cc %ld, chains mean %f\n", 
+                          harmonic_cnt, harmonic_cc, rts_founded > 0 ? (double) chains_sum / rts_founded : 0.0);
+    }
+    if (merge == 1) {
+        fprintf(out_file, "Merge: merged rts %d, merged tasks %d\n", merged_cnt, merged_tasks);
+    }
+    if (settled_cnt > 0) {
+        fprintf(out_file, "Settled: %d rts, not in the method statistics\n", settled_cnt);
+    }
+    if (fail_fast == 1) {
+        fprintf(out_file, "Fail-fast: non sched %d, missed %d, cc %ld\n", fail_fast_cnt, fail_fast_missed, fail_fast_cc);
+        // the methods are deterministic, so the ceil operations they used with the rts found non schedulable
+        // are the ones avoided without --verify, less the ones of the test with all the rts
+        if (fail_fast_verify == 1) {
+            fprintf(out_file, "%10s%15s\n", "method", "cc_saved");
+            for (i = 0; i < NUM_SCHED_METHODS; i++) {
+                if (methods[i].enabled == 0) {
+                    continue;
+                }
+                fprintf(out_file, "%10s%15ld\n", methods[i].method_name,
+                        fail_fast_saved[methods[i].method_id] - fail_fast_cc);
+            }
+        }
+    }
+    if (seed_type != SEED_SJODIN) {
+        fprintf(out_file, "Seed: %s\n", seed_names[seed_type]);
+        fprintf(out_file, "%10s%15s%15s%15s%15s\n", "method", "while_saved", "while_sjodin", "cc_saved", "cc_sjodin");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            int method_id = methods[i].method_id;
+            // the other methods do not use the seed
+            if (methods[i].enabled == 0 || method_id < RTA_ID || method_id > RTA4_ID) {
+                continue;
+            }
+            fprintf(out_file, "%10s%15ld%15ld%15ld%15ld\n", methods[i].method_name, 
+                    seed_while[0][method_id] - seed_while[1][method_id], seed_while[0][method_id],
+                    seed_cc[0][method_id] - seed_cc[1][method_id], seed_cc[0][method_id]);
+        }
+    }
+
+    if (features_file != NULL) {
+        fclose(features_file);
+    }
+    if (buckets_file != NULL) {
+        bucket_report(methods);
+        fclose(buckets_file);
+        fprintf(out_file, "Buckets: %d\n", num_buckets);
+    }
+    if (col_file != NULL) {
+        for (i = 0; i < NUM_COL_TABLES; i++) {
+            col_flush(i);
+        }
+        fclose(col_file);
+    }
+#ifdef USE_HDF5
+    if (store_path != NULL) {
+        store_close();
+        fprintf(out_file, "Store: %s %s\n", store_path, store_key);
+    }
+#endif
+    if (methods[AUTO_ID].enabled == 1) {
+        fprintf(out_file, "Auto:");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (auto_cnt[i] > 0) {
+                fprintf(out_file, " %s %d", methods[i].method_name, auto_cnt[i]);
+            }
+        }
+        fprintf(out_file, "\n");
+    }
+    if (methods[RTA4A_ID].enabled == 1) {
+        fprintf(out_file, "Anytime: budget %s %ld, slices mean %f, max %d\n", budget_names[budget_type], budget, 
+                rts_founded > 0 ? (double) rta4a_slices / rts_founded : 0.0, rta4a_slices_max);
+    }
+    if (telemetry_file != NULL) {
+        telemetry_rts(methods, 0, 1);
+        if (telemetry_file != stderr) {
+            fclose(telemetry_file);
+        }
+    }
+    if (ckpt_file != NULL) {
+        checkpoint_write(methods);
+        fclose(ckpt_file);
+        fprintf(out_file, "Checkpoint: %d rts resumed\n", ckpt_resumed);
+    }
+    if (cache_file != NULL) {
+        fclose(cache_file);
+        fprintf(out_file, "Cache: hits %ld, misses %ld\n", cache_hits, cache_misses);
+    }
+    if (sketch_path != NULL) {
+        fprintf(out_file, "Quantiles:\n");
+        fprintf(out_file, "%10s%8s%12s%12s%12s%12s%12s\n", "method", "metric", "p50", "p90", "p99", "p99.9", "max");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (methods[i].enabled == 0) {
+                continue;
+            }
+            for (k = 0; k < NUM_BUCKET_METRICS; k++) {
+                struct sketch_t *sk = &sketches[methods[i].method_id][k];
+                fprintf(out_file, "%10s%8s%12lu%12lu%12lu%12lu%12lu\n", methods[i].method_name, metric_names[k],
+                        sketch_quantile(sk, 0.5), sketch_quantile(sk, 0.9), sketch_quantile(sk, 0.99),
+                        sketch_quantile(sk, 0.999), sk->max);
+            }
+        }
+        // runs on other shards saved into the same file are merged
+        sketch_update(sketch_path, methods);
+    }
+    if (nsecs == 1) {
+        // the cache hits were not timed
+        fprintf(out_file, "Time:%s\n", cache_file != NULL ? " (without the cache hits)" : "");
+        fprintf(out_file, "%10s%15s%15s\n", "method", "nsecs_mean", "nsecs_std");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (methods[i].enabled == 1) {
+                fprintf(out_file, "%10s%15f%15f\n", methods[i].method_name, methods[i].result->nsecs_mean, 
+                        methods[i].result->nsecs_std);
+            }
+        }
+    }
+    if (trace == 1) {
+        trace_flush();
+        fclose(trace_file);
+        fprintf(out_file, "Trace: %ld records\n", trace_cnt);
+    }
+    if (attribution == 1) {
+        int attr_ids[] = {RTA2_ID, RTA3_ID, RTA4_ID};
+        fprintf(out_file, "Attribution:\n");
+        fprintf(out_file, "%10s%15s%15s%15s\n", "method", "cc_total", "exp_total", "hot_share");
+        for (i = 0; i < 3; i++) {
+            int m = attr_ids[i];
+            if (methods[m].enabled == 0) {
+                continue;
+            }
+            long cc_total = 0;
+            long exp_total = 0;
+            for (j = 0; j < attr_n; j++) {
+                cc_total += level_cc[m][j];
+                exp_total += level_exp[m][j];
+                // totals by priority level of the interfering task
+                fprintf(attr_file, "level,,%s,,%d,%ld,%ld\n", methods[m].method_name, j + 1, level_cc[m][j], level_exp[m][j]);
+            }
+            fprintf(out_file, "%10s%15ld%15ld%15f\n", methods[m].method_name, cc_total, exp_total,
+                    rts_founded > 0 ? hot_share[m] / rts_founded : 0.0);
+        }
+        fclose(attr_file);
+    }
+
+    if (mem == 1) {
+        fprintf(out_file, "Memory:\n");
+        fprintf(out_file, "%10s%15s%15s%15s\n", "method", "stack_mean", "stack_max", "heap_max");
+        for (i = 0; i < NUM_SCHED_METHODS; i++) {
+            if (methods[i].enabled == 0) {
+                continue;
+            }
+            fprintf(out_file, "%10s%15f%15ld%15ld\n", methods[i].method_name, methods[i].result->stack_mean,
+                    methods[i].result->stack_max, methods[i].result->heap_max);
+        }
+    }
 
     // print column names
     if (use_csv == 0) {
@@ -782,9 +6617,13 @@ int main(int argc, char **argv)
                       
     // print the results
     for (i = 0; i < NUM_SCHED_METHODS; i++) {
+        if (methods[i].enabled == 0) {
+            continue;
+        }
         save_result(methods[i].method_name, methods[i].result, use_csv, csv_sep);
     }
     
     return(EXIT_SUCCESS);
 }
+#endif
 
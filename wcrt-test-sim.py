@@ -379,6 +379,21 @@ def het2(rts):
     return [schedulable, wcrt, ceils, loops, for_loops, while_loops]
 
 
+def native_method(name, method_id):
+    """ Same as the method name, but using the wcrt module (see wcrtmodule.c) """
+    import wcrt
+
+    def method(rts):
+        c, t, d = [np.array([[task[k] for task in rts]]) for k in ["C", "T", "D"]]
+        sched, wcrt_, ceils, while_loops, for_loops = wcrt.analyse(c, t, d, method_id)
+        loops = for_loops + while_loops
+        return [sched[0] == wcrt.SCHED, wcrt_[0].tolist(), ceils[0].tolist(), loops[0].tolist(),
+                for_loops[0].tolist(), while_loops[0].tolist()]
+
+    method.__name__ = name
+    return method
+
+
 def get_args():
     """ Command line arguments """
     parser = ArgumentParser(description="Evaluate schedulability tests.")
@@ -393,6 +408,8 @@ def get_args():
                         default=None, type=str)
     parser.add_argument("--reuse-key", help="Replace DataFrame under key in the store",
                         default=False, action="store_true")         
+    parser.add_argument("--native", help="Use the methods of wcrt-test-sim.c (requires the wcrt module, see setup.py).",
+                        default=False, action="store_true")
     parser.add_argument("--verbose", help="Show extra information.", default=False, action="store_true") 
     return parser.parse_args()
 
@@ -418,6 +435,12 @@ def main():
     # method to evaluate
     rta_methods = [het2, rta, rta2, rta3, rta4]
 
+    if args.native:
+        import wcrt
+        rta_methods = [native_method("het2", wcrt.HET), native_method("rta", wcrt.RTA),
+                       native_method("rta2", wcrt.RTA2), native_method("rta3", wcrt.RTA3),
+                       native_method("rta4", wcrt.RTA4)]
+
     for file in args.files:
         if not os.path.isfile(file):
             print("{0}: file not found.".format(file))
@@ -0,0 +1,115 @@
+from __future__ import print_function
+
+import sys
+import numpy as np
+from argparse import ArgumentParser
+
+
+TRACE_MAGIC = b"WCRTTRC1"
+
+# same layout as struct trace_rec in wcrt-test-sim.c
+trace_dtype = np.dtype([("rts_id", "<i4"), ("old_tr", "<i4"), ("new_tr", "<i4"),
+                        ("i", "<u2"), ("j", "<u2"), ("iter", "<u2"),
+                        ("method", "u1"), ("pad", "u1")])
+
+
+def read_trace(trace_file):
+    """ Read the header and the records of a trace file written by wcrt-test-sim --trace """
+    with open(trace_file, "rb") as f:
+        magic = f.read(8)
+        if magic != TRACE_MAGIC:
+            print("{0}: not a trace file.".format(trace_file), file=sys.stderr)
+            sys.exit(1)
+
+        rec_size, num_methods = np.frombuffer(f.read(8), dtype="<u4")
+        if rec_size != trace_dtype.itemsize:
+            print("{0}: record size {1}, expected {2}.".format(trace_file, rec_size, trace_dtype.itemsize), file=sys.stderr)
+            sys.exit(1)
+
+        method_names = [f.read(8).rstrip(b"\0").decode() for _ in range(num_methods)]
+        records = np.fromfile(f, dtype=trace_dtype)
+
+    return method_names, records
+
+
+def convergence_stats(records, top):
+    """ Print the convergence statistics of the records of one method """
+    # one analysis for each (rts, task) pair
+    keys = records["rts_id"].astype(np.int64) * 65536 + records["i"]
+    analysis, idx = np.unique(keys, return_inverse=True)
+
+    iters = np.zeros(len(analysis), dtype=np.int64)
+    np.maximum.at(iters, idx, records["iter"])
+    updates = np.bincount(idx, minlength=len(analysis))
+
+    start = np.zeros(len(analysis), dtype=np.int64)
+    final = np.zeros(len(analysis), dtype=np.int64)
+    np.maximum.at(final, idx, records["new_tr"])
+    first = records["old_tr"] == 0
+    start[idx[first]] = records["new_tr"][first]
+
+    print("  analysed tasks: {0}".format(len(analysis)))
+    print("  updates: {0} ({1:.2f} per task)".format(len(records), updates.mean()))
+    print("  last while loop with an update, per task: mean {0:.2f}, p50 {1:.0f}, p95 {2:.0f}, max {3}".format(
+          iters.mean(), np.percentile(iters, 50), np.percentile(iters, 95), iters.max()))
+
+    growth = (final - start) / np.maximum(start, 1)
+    print("  growth from the initial value: mean {0:.3f}, max {1:.3f}".format(growth.mean(), growth.max()))
+
+    # mean increment of tr in each while loop
+    steps = records[records["old_tr"] > 0]
+    if len(steps) > 0:
+        inc = (steps["new_tr"] - steps["old_tr"]) / steps["old_tr"]
+        print("  {0:>6}{1:>12}{2:>15}".format("loop", "updates", "inc_mean"))
+        for it in range(1, min(int(steps["iter"].max()), 10) + 1):
+            sel = steps["iter"] == it
+            if sel.any():
+                print("  {0:>6}{1:>12}{2:>15.5f}".format(it, sel.sum(), inc[sel].mean()))
+
+    # tasks with most while loops with an update
+    order = np.argsort(-iters, kind="stable")[:top]
+    print("  {0:>8}{1:>6}{2:>8}{3:>10}{4:>10}".format("rts_id", "task", "loops", "start", "last_tr"))
+    for k in order:
+        print("  {0:>8}{1:>6}{2:>8}{3:>10}{4:>10}".format(analysis[k] // 65536, analysis[k] % 65536 + 1,
+                                                          iters[k], start[k], final[k]))
+
+
+def get_args():
+    """ Command line arguments """
+    parser = ArgumentParser(description="Decode a trace file written by wcrt-test-sim --trace, and print " +
+                                        "convergence statistics of the fixpoint iterations.")
+    parser.add_argument("file", help="Trace file.", type=str)
+    parser.add_argument("--methods", help="Methods to include in the report.", nargs="+")
+    parser.add_argument("--rts", help="Only the records of this rts.", type=int)
+    parser.add_argument("--top", help="Number of tasks with most while loops listed.", type=int, default=10)
+    parser.add_argument("--dump", help="Print the records as CSV.", default=False, action="store_true")
+    return parser.parse_args()
+
+
+def main():
+    args = get_args()
+
+    method_names, records = read_trace(args.file)
+
+    if args.rts is not None:
+        records = records[records["rts_id"] == args.rts]
+
+    if args.dump:
+        print("method,rts_id,i,j,iter,old_tr,new_tr")
+        for r in records:
+            print("{0},{1},{2},{3},{4},{5},{6}".format(method_names[r["method"]], r["rts_id"], r["i"] + 1,
+                                                       r["j"] + 1, r["iter"], r["old_tr"], r["new_tr"]))
+        return
+
+    for method_id, method in enumerate(method_names):
+        if args.methods and method not in args.methods:
+            continue
+        method_records = records[records["method"] == method_id]
+        if len(method_records) == 0:
+            continue
+        print("{0}:".format(method))
+        convergence_stats(method_records, args.top)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,75 @@
+from __future__ import print_function
+
+import sys
+import zlib
+import struct
+import numpy as np
+
+
+RESULTS_MAGIC = b"WCRTCOL1"
+CHUNK_MAGIC = b"CHNK"
+COL_NAME_LEN = 16
+
+# tables of the results file, as in wcrt-test-sim.c
+TABLES = {"rts": 0, "task": 1}
+
+# method ids of the HDF5 stores written by wcrt-test-mbed.py and wcrt-test-sim --store (store_method_ids)
+STORE_METHOD_NAMES = {0: 'het', 1: 'het2', 2: 'rta', 3: 'rta2', 4: 'rta3', 5: 'rta4', 6: 'heti', 7: 'auto', 8: 'rta4a'}
+
+
+def is_results_file(results_file):
+    """ Check if the file is a results file written by wcrt-test-sim --results """
+    with open(results_file, "rb") as f:
+        return f.read(len(RESULTS_MAGIC)) == RESULTS_MAGIC
+
+
+def read_header(f):
+    """ Read the header of the results file, and return the method names """
+    if f.read(len(RESULTS_MAGIC)) != RESULTS_MAGIC:
+        print("{0}: not a results file.".format(f.name), file=sys.stderr)
+        sys.exit(1)
+
+    num_methods, = struct.unpack("<I", f.read(4))
+    return [f.read(8).rstrip(b"\0").decode() for _ in range(num_methods)]
+
+
+def read_chunks(results_file, table="rts", columns=None):
+    """
+    Iterate over the chunks of the table in the results file, as a dict of
+    numpy arrays with the selected columns (default: all). Only one chunk is
+    in memory at a time, and the columns not selected are skipped.
+    """
+    table_id = TABLES[table]
+
+    with open(results_file, "rb") as f:
+        read_header(f)
+
+        while True:
+            chunk = f.read(16)
+            if len(chunk) < 16:
+                break
+            if chunk[:4] != CHUNK_MAGIC:
+                print("{0}: corrupted chunk at {1}.".format(results_file, f.tell() - 16), file=sys.stderr)
+                sys.exit(1)
+
+            chunk_table, rows, cols = struct.unpack("<III", chunk[4:])
+            data = {}
+            for _ in range(cols):
+                name = f.read(COL_NAME_LEN).rstrip(b"\0").decode()
+                raw_len, stored_len = struct.unpack("<II", f.read(8))
+                if chunk_table != table_id or (columns is not None and name not in columns):
+                    f.seek(stored_len, 1)
+                    continue
+                values = f.read(stored_len)
+                if stored_len < raw_len:
+                    values = zlib.decompress(values)
+                data[name] = np.frombuffer(values, dtype="<i8", count=rows)
+
+            if chunk_table == table_id:
+                yield data
+
+
+def method_names(results_file):
+    """ Method names, by method id """
+    with open(results_file, "rb") as f:
+        return read_header(f)
@@ -0,0 +1,178 @@
+from __future__ import print_function
+
+import os
+import sys
+import fcntl
+import struct
+import numpy as np
+from argparse import ArgumentParser
+
+
+SKETCH_MAGIC = b"WCRTSKT1"
+
+# same bucketing as the sketches of wcrt-test-sim.c
+SUB_BITS = 7
+SUB_COUNT = 1 << SUB_BITS
+NUM_BUCKETS = (64 - SUB_BITS + 1) * SUB_COUNT
+
+QUANTILES = [0.5, 0.9, 0.99, 0.999]
+
+
+def bucket_index(values):
+    """ Bucket of each value, as sketch_index in wcrt-test-sim.c """
+    values = np.asarray(values, dtype=np.uint64)
+    msb = np.zeros(values.shape, dtype=np.int64)
+    large = values >= SUB_COUNT
+    msb[large] = np.floor(np.log2(values[large].astype(np.float64))).astype(np.int64)
+    # log2 of a float64 may round up just below a power of two
+    over = large & ((values >> msb.astype(np.uint64)) == 0)
+    msb[over] -= 1
+    e = np.maximum(msb - SUB_BITS, 0)
+    return np.where(large, e * SUB_COUNT + (values >> e.astype(np.uint64)).astype(np.int64), values.astype(np.int64))
+
+
+def bucket_value(index):
+    """ Lowest value of a bucket, as sketch_value in wcrt-test-sim.c """
+    if index < SUB_COUNT:
+        return index
+    e = index // SUB_COUNT - 1
+    return (index - e * SUB_COUNT) << e
+
+
+class Sketch(object):
+    """ Mergeable quantile sketch of non negative integer values """
+
+    def __init__(self):
+        self.count = 0
+        self.min = 0
+        self.max = 0
+        self.counts = np.zeros(NUM_BUCKETS, dtype=np.uint64)
+
+    def add(self, values):
+        """ Add a value, or an array of values """
+        values = np.atleast_1d(np.asarray(values)).astype(np.int64).clip(min=0)
+        if len(values) == 0:
+            return
+        vmin, vmax = int(values.min()), int(values.max())
+        self.min = vmin if self.count == 0 else min(self.min, vmin)
+        self.max = vmax if self.count == 0 else max(self.max, vmax)
+        self.count += len(values)
+        np.add.at(self.counts, bucket_index(values), np.uint64(1))
+
+    def merge(self, other):
+        """ Add the values of other sketch """
+        if other.count == 0:
+            return
+        self.min = other.min if self.count == 0 else min(self.min, other.min)
+        self.max = other.max if self.count == 0 else max(self.max, other.max)
+        self.count += other.count
+        self.counts += other.counts
+
+    def quantile(self, q):
+        """ Value of the q quantile, as sketch_quantile in wcrt-test-sim.c """
+        if self.count == 0:
+            return 0
+        rank = max(int(np.ceil(q * self.count)), 1)
+        i = min(int(np.searchsorted(np.cumsum(self.counts), rank)), NUM_BUCKETS - 1)
+        v = bucket_value(i) + (bucket_value(i + 1) - bucket_value(i) - 1) // 2
+        return min(max(v, self.min), self.max)
+
+
+def read_sketches(sketch_file):
+    """ Read a sketches file, as a dict of Sketch by (method, metric) """
+    sketches = {}
+    with open(sketch_file, "rb") as f:
+        if f.read(len(SKETCH_MAGIC)) != SKETCH_MAGIC:
+            print("{0}: not a sketches file.".format(sketch_file), file=sys.stderr)
+            sys.exit(1)
+
+        sub_bits, num_sketches = struct.unpack("<II", f.read(8))
+        if sub_bits != SUB_BITS:
+            print("{0}: sketches with {1} sub-bucket bits, expected {2}.".format(sketch_file, sub_bits, SUB_BITS),
+                  file=sys.stderr)
+            sys.exit(1)
+
+        for _ in range(num_sketches):
+            method = f.read(8).rstrip(b"\0").decode()
+            metric = f.read(8).rstrip(b"\0").decode()
+            sk = Sketch()
+            sk.count, sk.min, sk.max, num_buckets = struct.unpack("<QQQI", f.read(28))
+            pairs = np.frombuffer(f.read(16 * num_buckets), dtype="<u8").reshape(-1, 2)
+            sk.counts[pairs[:, 0].astype(np.int64)] = pairs[:, 1]
+            sketches.setdefault((method, metric), Sketch()).merge(sk)
+
+    return sketches
+
+
+def write_sketches(sketch_file, sketches):
+    """
+    Write a dict of Sketch by (method, metric), in the format of wcrt-test-sim
+    --sketch, into sketch_file.tmp, renamed to sketch_file once complete.
+    """
+    with open(sketch_file + ".tmp", "wb") as f:
+        f.write(SKETCH_MAGIC)
+        f.write(struct.pack("<II", SUB_BITS, len(sketches)))
+        for (method, metric), sk in sorted(sketches.items()):
+            f.write(method.encode()[:7].ljust(8, b"\0"))
+            f.write(metric.encode()[:7].ljust(8, b"\0"))
+            nonzero = np.flatnonzero(sk.counts)
+            f.write(struct.pack("<QQQI", sk.count, sk.min, sk.max, len(nonzero)))
+            pairs = np.column_stack([nonzero.astype(np.uint64), sk.counts[nonzero]])
+            f.write(pairs.astype("<u8").tobytes())
+    os.rename(sketch_file + ".tmp", sketch_file)
+
+
+def update_file(sketch_file, sketches):
+    """
+    Merge the sketches already saved in sketch_file into sketches, and save them
+    all back, holding an exclusive flock on sketch_file.lock as wcrt-test-sim
+    does, so that concurrent runs on the same host do not lose each other's
+    sketches.
+    """
+    with open(sketch_file + ".lock", "a") as lock:
+        fcntl.flock(lock, fcntl.LOCK_EX)
+        if os.path.isfile(sketch_file):
+            for key, sk in read_sketches(sketch_file).items():
+                sketches.setdefault(key, Sketch()).merge(sk)
+        write_sketches(sketch_file, sketches)
+
+
+def merge_files(files):
+    """ Merge the sketches of several files (for example, from different shards) """
+    sketches = {}
+    for sketch_file in files:
+        for key, sk in read_sketches(sketch_file).items():
+            sketches.setdefault(key, Sketch()).merge(sk)
+    return sketches
+
+
+def print_report(sketches, out=sys.stdout):
+    """ Print p50/p90/p99/p99.9/max of each sketch """
+    print("{0:>10}{1:>8}{2:>12}{3:>12}{4:>12}{5:>12}{6:>12}{7:>12}".format(
+          "method", "metric", "count", "p50", "p90", "p99", "p99.9", "max"), file=out)
+    for (method, metric), sk in sorted(sketches.items()):
+        print("{0:>10}{1:>8}{2:>12}".format(method, metric, sk.count) +
+              "".join("{0:>12}".format(sk.quantile(q)) for q in QUANTILES) + "{0:>12}".format(sk.max), file=out)
+
+
+def get_args():
+    """ Command line arguments """
+    parser = ArgumentParser(description="Merge the quantile sketches written by wcrt-test-sim --sketch or " +
+                                        "wcrt-test-mbed.py --sketch, and print their quantiles.")
+    parser.add_argument("files", help="Sketches file(s).", nargs="+", type=str)
+    parser.add_argument("--out", help="Save the merged sketches into file.", type=str, metavar="file")
+    return parser.parse_args()
+
+
+def main():
+    args = get_args()
+
+    sketches = merge_files(args.files)
+    print_report(sketches)
+
+    if args.out:
+        write_sketches(args.out, sketches)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,166 @@
+/*
+ * Python module with the methods of wcrt-test-sim.c. Build with:
+ *   python setup.py build_ext --inplace
+ *
+ * import numpy as np, wcrt
+ * sched, wcrt, cc, loops_w, loops_f = wcrt.analyse(c, t, d, wcrt.RTA4)
+ *
+ * c, t and d are arrays with one row for each rts, with the tasks in priority
+ * order. If the rts have different number of tasks, n has the number of tasks
+ * of each rts, and the remaining columns are ignored (and 0 in the results).
+ * As in the QUERY requests of --serve, the method must be one of the exact
+ * methods (auto and rta4a are not valid), and only rta is valid if a task
+ * has D < T, as the other methods assume D = T.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#define WCRT_NO_MAIN
+#include "wcrt-test-sim.c"
+
+static PyObject *wcrt_analyse(PyObject *self, PyObject *args, PyObject *kwds)
+{
+    static char *kwlist[] = {"c", "t", "d", "method", "n", NULL};
+    PyObject *c_obj, *t_obj, *d_obj, *n_obj = Py_None;
+    int method_id;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOOi|O", kwlist, &c_obj, &t_obj, &d_obj, &method_id, &n_obj)) {
+        return NULL;
+    }
+
+    if (method_id < 0 || method_id >= NUM_SCHED_METHODS || method_id == AUTO_ID || method_id == RTA4A_ID) {
+        PyErr_Format(PyExc_ValueError, "invalid method %d", method_id);
+        return NULL;
+    }
+
+    int flags = NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST;
+    PyArrayObject *c_arr = (PyArrayObject*) PyArray_FROMANY(c_obj, NPY_INT32, 1, 2, flags);
+    PyArrayObject *t_arr = (PyArrayObject*) PyArray_FROMANY(t_obj, NPY_INT32, 1, 2, flags);
+    PyArrayObject *d_arr = (PyArrayObject*) PyArray_FROMANY(d_obj, NPY_INT32, 1, 2, flags);
+    PyArrayObject *n_arr = NULL;
+    PyObject *result = NULL;
+    PyArrayObject *out[5] = {NULL, NULL, NULL, NULL, NULL};   // sched, wcrt, cc, loops_w, loops_f
+
+    if (c_arr == NULL || t_arr == NULL || d_arr == NULL) {
+        goto done;
+    }
+
+    int ndim = PyArray_NDIM(c_arr);
+    npy_intp num_rts = ndim == 2 ? PyArray_DIM(c_arr, 0) : 1;
+    npy_intp max_n = PyArray_DIM(c_arr, ndim - 1);
+
+    if (PyArray_NDIM(t_arr) != ndim || PyArray_NDIM(d_arr) != ndim ||
+        PyArray_SIZE(t_arr) != num_rts * max_n || PyArray_SIZE(d_arr) != num_rts * max_n ||
+        (ndim == 2 && (PyArray_DIM(t_arr, 1) != max_n || PyArray_DIM(d_arr, 1) != max_n))) {
+        PyErr_SetString(PyExc_ValueError, "c, t and d must have the same shape");
+        goto done;
+    }
+
+    if (n_obj != Py_None) {
+        n_arr = (PyArrayObject*) PyArray_FROMANY(n_obj, NPY_INT32, 0, 1, flags);
+        if (n_arr == NULL) {
+            goto done;
+        }
+        if (PyArray_SIZE(n_arr) != num_rts) {
+            PyErr_SetString(PyExc_ValueError, "n must have one value for each rts");
+            goto done;
+        }
+    }
+
+    const int32_t *c = PyArray_DATA(c_arr);
+    const int32_t *t = PyArray_DATA(t_arr);
+    const int32_t *d = PyArray_DATA(d_arr);
+    const int32_t *n = n_arr != NULL ? PyArray_DATA(n_arr) : NULL;
+
+    // the methods do not check the parameters
+    npy_intp k, i;
+    for (k = 0; k < num_rts; k++) {
+        int ntask = n != NULL ? n[k] : (int) max_n;
+        if (ntask < 1 || ntask > max_n) {
+            PyErr_Format(PyExc_ValueError, "rts %zd: invalid number of tasks %d", k, ntask);
+            goto done;
+        }
+        for (i = k * max_n; i < k * max_n + ntask; i++) {
+            if (c[i] <= 0 || c[i] >= t[i] || d[i] < c[i] || d[i] > t[i]) {
+                PyErr_Format(PyExc_ValueError, "rts %zd: invalid task %zd", k, i - k * max_n);
+                goto done;
+            }
+            if (d[i] < t[i] && method_id != RTA_ID) {
+                PyErr_Format(PyExc_ValueError, "rts %zd: task %zd has D < T, only valid with RTA", k, i - k * max_n);
+                goto done;
+            }
+        }
+    }
+
+    npy_intp dims[2] = {num_rts, max_n};
+    out[0] = (PyArrayObject*) PyArray_ZEROS(1, dims, NPY_INT32, 0);
+    for (i = 1; i < 5; i++) {
+        out[i] = (PyArrayObject*) PyArray_ZEROS(2, dims, NPY_INT32, 0);
+    }
+    for (i = 0; i < 5; i++) {
+        if (out[i] == NULL) {
+            goto done;
+        }
+    }
+
+    int32_t *sched = PyArray_DATA(out[0]);
+    int32_t *wcrt = PyArray_DATA(out[1]);
+    int32_t *cc = PyArray_DATA(out[2]);
+    int32_t *loops_w = PyArray_DATA(out[3]);
+    int32_t *loops_f = PyArray_DATA(out[4]);
+
+    Py_BEGIN_ALLOW_THREADS
+    for (k = 0; k < num_rts; k++) {
+        npy_intp o = k * max_n;
+        int ntask = n != NULL ? n[k] : (int) max_n;
+        sched[k] = analyse_tasks(ntask, c + o, t + o, d + o, method_id, wcrt + o, cc + o, loops_w + o, loops_f + o);
+    }
+    Py_END_ALLOW_THREADS
+
+    result = Py_BuildValue("(OOOOO)", out[0], out[1], out[2], out[3], out[4]);
+
+done:
+    for (i = 0; i < 5; i++) {
+        Py_XDECREF(out[i]);
+    }
+    Py_XDECREF(c_arr);
+    Py_XDECREF(t_arr);
+    Py_XDECREF(d_arr);
+    Py_XDECREF(n_arr);
+
+    return result;
+}
+
+static PyMethodDef wcrt_methods[] = {
+    {"analyse", (PyCFunction) wcrt_analyse, METH_VARARGS | METH_KEYWORDS,
+     "analyse(c, t, d, method, n=None) -> (sched, wcrt, cc, loops_w, loops_f)\n\n"
+     "Evaluate a batch of rts with the method (HET, RTA, ...). The GIL is released\n"
+     "while the rts are evaluated. Only RTA is valid if a task has D < T."},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef wcrt_module = {
+    PyModuleDef_HEAD_INIT, "wcrt", "Schedulability analysis methods of wcrt-test-sim.", -1, wcrt_methods
+};
+
+PyMODINIT_FUNC PyInit_wcrt(void)
+{
+    import_array();
+
+    PyObject *m = PyModule_Create(&wcrt_module);
+    if (m == NULL) {
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(m, "HET", HET_ID);
+    PyModule_AddIntConstant(m, "RTA", RTA_ID);
+    PyModule_AddIntConstant(m, "RTA2", RTA2_ID);
+    PyModule_AddIntConstant(m, "RTA3", RTA3_ID);
+    PyModule_AddIntConstant(m, "RTA4", RTA4_ID);
+    PyModule_AddIntConstant(m, "HETI", HETI_ID);
+    PyModule_AddIntConstant(m, "SCHED", SCHED);
+
+    return m;
+}